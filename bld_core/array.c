@@ -1,5 +1,6 @@
 #include <string.h>
 #include "logging.h"
+#include "mem.h"
 #include "array.h"
 
 int array_increase_capacity(bld_array*, size_t);
@@ -17,7 +18,7 @@ bld_array array_new(size_t value_size) {
 }
 
 void array_free(bld_array* array) {
-    free(array->values);
+    mem_free(array->values);
 }
 
 bld_array array_copy(const bld_array* array) {
@@ -26,7 +27,7 @@ bld_array array_copy(const bld_array* array) {
     cpy.capacity = array->size;
     cpy.size = array->size;
     cpy.value_size = array->value_size;
-    cpy.values = malloc(array->size * array->value_size);
+    cpy.values = mem_malloc(array->size * array->value_size);
 
     if (cpy.values == NULL) {
         log_fatal("Could not allocate");
@@ -39,7 +40,7 @@ bld_array array_copy(const bld_array* array) {
 int array_increase_capacity(bld_array* array, size_t capacity) {
     void* values;
 
-    values = realloc(array->values, capacity * array->value_size);
+    values = mem_realloc(array->values, capacity * array->value_size);
     if (values == NULL) {return 0;}
 
     array->capacity = capacity;
@@ -120,7 +121,7 @@ void array_reverse(bld_array* array) {
         return;
     }
 
-    temp = malloc(array->value_size);
+    temp = mem_malloc(array->value_size);
     if (temp == NULL) {log_fatal("array_reverse: internal error, could not allocate temp");}
 
     head = array->values;
@@ -135,5 +136,5 @@ void array_reverse(bld_array* array) {
         tail = ((char*) tail) - array->value_size;
     }
 
-    free(temp);
+    mem_free(temp);
 }
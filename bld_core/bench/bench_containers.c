@@ -0,0 +1,387 @@
+/* Microbenchmarks of the core containers, prints the median of BENCH_RUNS runs as one JSON object per case */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../os.h"
+#include "../hash.h"
+#include "../set.h"
+#include "../array.h"
+#include "../dstr.h"
+#include "../path.h"
+#include "../iter.h"
+
+#define BENCH_RUNS (11)
+
+typedef uintmax_t (*bench_func)(size_t);
+
+typedef struct bench_case {
+    char* name;
+    bench_func func;
+} bench_case;
+
+bld_hash bench_key(size_t);
+bld_set bench_filled_set(size_t);
+bld_array bench_filled_array(size_t);
+int bench_compare_time(const void*, const void*);
+void bench_report(char*, bench_func, size_t);
+
+uintmax_t bench_set_insert(size_t);
+uintmax_t bench_set_lookup(size_t);
+uintmax_t bench_set_lookup_missing(size_t);
+uintmax_t bench_set_remove(size_t);
+uintmax_t bench_set_iterate(size_t);
+uintmax_t bench_set_copy(size_t);
+uintmax_t bench_array_push(size_t);
+uintmax_t bench_array_get(size_t);
+uintmax_t bench_array_iterate(size_t);
+uintmax_t bench_array_copy(size_t);
+uintmax_t bench_string_append(size_t);
+uintmax_t bench_string_append_char(size_t);
+uintmax_t bench_string_hash(size_t);
+uintmax_t bench_path_append(size_t);
+uintmax_t bench_path_ends_with(size_t);
+
+/* Sinks results so the measured loops are not optimized away */
+volatile uintmax_t bench_sink;
+
+bld_hash bench_key(size_t i) {
+    return hash_combine(0, i);
+}
+
+bld_set bench_filled_set(size_t size) {
+    size_t i, value;
+    bld_set set;
+
+    set = set_new(sizeof(size_t));
+    for (i = 0; i < size; i++) {
+        value = i;
+        set_add(&set, bench_key(i), &value);
+    }
+    return set;
+}
+
+bld_array bench_filled_array(size_t size) {
+    size_t i;
+    bld_array array;
+
+    array = array_new(sizeof(size_t));
+    for (i = 0; i < size; i++) {
+        array_push(&array, &i);
+    }
+    return array;
+}
+
+uintmax_t bench_set_insert(size_t size) {
+    size_t i, value;
+    uintmax_t start, elapsed;
+    bld_set set;
+
+    set = set_new(sizeof(size_t));
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        value = i;
+        set_add(&set, bench_key(i), &value);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    set_free(&set);
+    return elapsed;
+}
+
+uintmax_t bench_set_lookup(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_set set;
+
+    set = bench_filled_set(size);
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        bench_sink += *(size_t*) set_get(&set, bench_key(i));
+    }
+    elapsed = os_time_monotonic() - start;
+
+    set_free(&set);
+    return elapsed;
+}
+
+uintmax_t bench_set_lookup_missing(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_set set;
+
+    set = bench_filled_set(size);
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        bench_sink += set_has(&set, bench_key(size + i));
+    }
+    elapsed = os_time_monotonic() - start;
+
+    set_free(&set);
+    return elapsed;
+}
+
+uintmax_t bench_set_remove(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_set set;
+
+    set = bench_filled_set(size);
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        set_remove(&set, bench_key(i));
+    }
+    elapsed = os_time_monotonic() - start;
+
+    set_free(&set);
+    return elapsed;
+}
+
+uintmax_t bench_set_iterate(size_t size) {
+    uintmax_t start, elapsed;
+    bld_iter iter;
+    bld_set set;
+    size_t* value;
+
+    set = bench_filled_set(size);
+    start = os_time_monotonic();
+    iter = iter_set(&set);
+    while (iter_next(&iter, (void**) &value)) {
+        bench_sink += *value;
+    }
+    elapsed = os_time_monotonic() - start;
+
+    set_free(&set);
+    return elapsed;
+}
+
+uintmax_t bench_set_copy(size_t size) {
+    uintmax_t start, elapsed;
+    bld_set set, copy;
+
+    set = bench_filled_set(size);
+    start = os_time_monotonic();
+    copy = set_copy(&set);
+    elapsed = os_time_monotonic() - start;
+
+    bench_sink += copy.size;
+    set_free(&copy);
+    set_free(&set);
+    return elapsed;
+}
+
+uintmax_t bench_array_push(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_array array;
+
+    array = array_new(sizeof(size_t));
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        array_push(&array, &i);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    array_free(&array);
+    return elapsed;
+}
+
+uintmax_t bench_array_get(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_array array;
+
+    array = bench_filled_array(size);
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        bench_sink += *(size_t*) array_get(&array, (i * 7919) % size);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    array_free(&array);
+    return elapsed;
+}
+
+uintmax_t bench_array_iterate(size_t size) {
+    uintmax_t start, elapsed;
+    bld_iter iter;
+    bld_array array;
+    size_t* value;
+
+    array = bench_filled_array(size);
+    start = os_time_monotonic();
+    iter = iter_array(&array);
+    while (iter_next(&iter, (void**) &value)) {
+        bench_sink += *value;
+    }
+    elapsed = os_time_monotonic() - start;
+
+    array_free(&array);
+    return elapsed;
+}
+
+uintmax_t bench_array_copy(size_t size) {
+    uintmax_t start, elapsed;
+    bld_array array, copy;
+
+    array = bench_filled_array(size);
+    start = os_time_monotonic();
+    copy = array_copy(&array);
+    elapsed = os_time_monotonic() - start;
+
+    bench_sink += copy.size;
+    array_free(&copy);
+    array_free(&array);
+    return elapsed;
+}
+
+uintmax_t bench_string_append(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_string str;
+
+    str = string_new();
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        string_append_string(&str, "-Wmissing-prototypes");
+    }
+    elapsed = os_time_monotonic() - start;
+
+    bench_sink += str.size;
+    string_free(&str);
+    return elapsed;
+}
+
+uintmax_t bench_string_append_char(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_string str;
+
+    str = string_new();
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        string_append_char(&str, 'a' + i % 26);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    bench_sink += str.size;
+    string_free(&str);
+    return elapsed;
+}
+
+uintmax_t bench_string_hash(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    char* names;
+
+    /* Symbol shaped names of at most 32 characters, generated before timing */
+    names = malloc(size * 32);
+    if (names == NULL) {return 0;}
+    for (i = 0; i < size; i++) {
+        sprintf(names + i * 32, "bench_symbol_%lu", (unsigned long) i);
+    }
+
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        bench_sink += string_hash(names + i * 32);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    free(names);
+    return elapsed;
+}
+
+uintmax_t bench_path_append(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_path path;
+
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        path = path_from_string("project/src");
+        path_append_string(&path, "component");
+        path_append_string(&path, "file.c");
+        bench_sink += path.str.size;
+        path_free(&path);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    return elapsed;
+}
+
+uintmax_t bench_path_ends_with(size_t size) {
+    size_t i;
+    uintmax_t start, elapsed;
+    bld_path path, hit, miss;
+
+    path = path_from_string("./project/src/component/file.c");
+    hit = path_from_string("component/file.c");
+    miss = path_from_string("component/main.c");
+
+    start = os_time_monotonic();
+    for (i = 0; i < size; i++) {
+        bench_sink += path_ends_with(&path, i % 2 ? &hit : &miss);
+    }
+    elapsed = os_time_monotonic() - start;
+
+    path_free(&path);
+    path_free(&hit);
+    path_free(&miss);
+    return elapsed;
+}
+
+int bench_compare_time(const void* a, const void* b) {
+    uintmax_t x, y;
+
+    x = *(const uintmax_t*) a;
+    y = *(const uintmax_t*) b;
+    return (x > y) - (x < y);
+}
+
+void bench_report(char* name, bench_func func, size_t size) {
+    int i;
+    uintmax_t times[BENCH_RUNS];
+
+    for (i = 0; i < BENCH_RUNS; i++) {
+        times[i] = func(size);
+    }
+    qsort(times, BENCH_RUNS, sizeof(uintmax_t), bench_compare_time);
+
+    printf("{\"bench\":\"containers\",\"case\":\"%s\",\"size\":%lu,\"runs\":%d,\"median_ns\":%lu,\"ns_per_op\":%.2f}\n",
+        name,
+        (unsigned long) size,
+        BENCH_RUNS,
+        (unsigned long) times[BENCH_RUNS / 2],
+        (double) times[BENCH_RUNS / 2] / size
+    );
+}
+
+int main(void) {
+    size_t i, j;
+    size_t sizes[] = {100, 10000, 100000};
+    bench_case cases[] = {
+        {"set_insert", bench_set_insert},
+        {"set_lookup", bench_set_lookup},
+        {"set_lookup_missing", bench_set_lookup_missing},
+        {"set_remove", bench_set_remove},
+        {"set_iterate", bench_set_iterate},
+        {"set_copy", bench_set_copy},
+        {"array_push", bench_array_push},
+        {"array_get", bench_array_get},
+        {"array_iterate", bench_array_iterate},
+        {"array_copy", bench_array_copy},
+        {"string_append", bench_string_append},
+        {"string_append_char", bench_string_append_char},
+        {"string_hash", bench_string_hash},
+        {"path_append", bench_path_append},
+        {"path_ends_with", bench_path_ends_with}
+    };
+
+    bench_sink = 0;
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        for (j = 0; j < sizeof(sizes) / sizeof(sizes[0]); j++) {
+            bench_report(cases[i].name, cases[i].func, sizes[j]);
+        }
+    }
+
+    return 0;
+}
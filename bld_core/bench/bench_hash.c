@@ -0,0 +1,122 @@
+/* Compares string_hash against the previous djb2 hash: throughput and probe lengths of a filled bld_set */
+#include <stdio.h>
+#include <string.h>
+#include "../os.h"
+#include "../set.h"
+#include "../dstr.h"
+
+#define BENCH_KEYS (200000)
+#define BENCH_RUNS (10)
+
+typedef bld_hash (*bench_hash_func)(char*);
+
+bld_hash bench_djb2(char*);
+bld_hash bench_string_hash(char*);
+char** bench_keys(void);
+void bench_run(char*, bench_hash_func, char**);
+
+bld_hash bench_djb2(char* str) {
+    bld_hash seed;
+    char c;
+
+    seed = 5029;
+    while ((c = *str++) != '\0') {
+        seed = (seed << 5) + seed + c;
+    }
+    return seed;
+}
+
+bld_hash bench_string_hash(char* str) {
+    return string_hash(str);
+}
+
+char** bench_keys(void) {
+    int i;
+    char name[128];
+    char** keys;
+
+    keys = malloc(BENCH_KEYS * sizeof(char*));
+    if (keys == NULL) {return NULL;}
+
+    /* Symbol and path shaped keys, short and sharing long prefixes like real projects */
+    for (i = 0; i < BENCH_KEYS; i++) {
+        if (i % 2 == 0) {
+            sprintf(name, "module_%d_function_%d", i / 64, i % 64);
+        } else {
+            sprintf(name, "src/component_%d/file_%d.c", i / 128, i % 128);
+        }
+        keys[i] = malloc(strlen(name) + 1);
+        if (keys[i] == NULL) {return NULL;}
+        strcpy(keys[i], name);
+    }
+
+    return keys;
+}
+
+void bench_run(char* name, bench_hash_func hash, char** keys) {
+    int i, run;
+    size_t slot, longest, total, duplicates;
+    bld_hash sink;
+    uintmax_t start, elapsed, best;
+    bld_set set;
+
+    best = 0;
+    sink = 0;
+    for (run = 0; run < BENCH_RUNS; run++) {
+        start = os_time_monotonic();
+        for (i = 0; i < BENCH_KEYS; i++) {
+            sink ^= hash(keys[i]);
+        }
+        elapsed = os_time_monotonic() - start;
+        if (run == 0 || elapsed < best) {best = elapsed;}
+    }
+
+    set = set_new(0);
+    duplicates = 0;
+    for (i = 0; i < BENCH_KEYS; i++) {
+        if (set_add(&set, hash(keys[i]), NULL)) {duplicates += 1;}
+    }
+
+    longest = 0;
+    total = 0;
+    for (slot = 0; slot < set.capacity + set.max_offset; slot++) {
+        if (set.offset[slot] >= set.max_offset) {continue;}
+        total += set.offset[slot];
+        if (set.offset[slot] > longest) {longest = set.offset[slot];}
+    }
+
+    /* A clustering hash forces the set to grow early, compare the load together with the probes */
+    printf("%-12s %.3f ms, %.1f ns/key, load %.2f, mean probe %.3f, longest probe %lu, collisions %lu, check %lu\n",
+        name,
+        (double) best / 1e6,
+        (double) best / BENCH_KEYS,
+        (double) set.size / set.capacity,
+        (double) total / set.size,
+        (unsigned long) longest,
+        (unsigned long) duplicates,
+        (unsigned long) (sink & 0xff)
+    );
+
+    set_free(&set);
+}
+
+int main(void) {
+    int i;
+    char** keys;
+
+    keys = bench_keys();
+    if (keys == NULL) {
+        printf("Could not allocate keys\n");
+        return 1;
+    }
+
+    printf("%d keys, best of %d\n", BENCH_KEYS, BENCH_RUNS);
+    bench_run("djb2", bench_djb2, keys);
+    bench_run("string_hash", bench_string_hash, keys);
+
+    for (i = 0; i < BENCH_KEYS; i++) {
+        free(keys[i]);
+    }
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,352 @@
+/* Times the phases of a warm build on a generated C project, prints one JSON object per phase */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../logging.h"
+#include "../os.h"
+#include "../project.h"
+#include "../incremental.h"
+#include "../linker/linker.h"
+
+#define BENCH_CACHE ".bld_cache"
+#define BENCH_EXECUTABLE "bench_phases.out"
+#define BENCH_BRANCHING (4)
+#define BENCH_RUNS (5)
+
+typedef struct bench_config {
+    int files;
+    int depth;
+    int fanout;
+    int symbols;
+    char root[128];
+} bench_config;
+
+typedef struct bench_phase {
+    char* name;
+    uintmax_t best;
+    uintmax_t total;
+} bench_phase;
+
+typedef enum bench_phase_index {
+    BENCH_LOAD_CACHE,
+    BENCH_RESOLVE,
+    BENCH_EXTRACT_INCLUDES,
+    BENCH_EXTRACT_SYMBOLS,
+    BENCH_NOOP_COMPILE,
+    BENCH_SAVE_CACHE,
+    BENCH_PHASES
+} bench_phase_index;
+
+int bench_parse_argument(int, char**, int, int, int);
+void bench_directory(bench_config*, int, char*);
+void bench_include(bench_config*, int, char*);
+int bench_include_taken(int*, int, int);
+void bench_generate(bench_config*);
+bld_path bench_root(bench_config*);
+bld_forward_project bench_forward_project(bld_path*, bld_linker_type);
+void bench_record(bench_phase*, int, uintmax_t);
+void bench_run(bld_path*, bench_phase*, int);
+void bench_link(bench_config*, bld_path*, bld_linker_type);
+
+int bench_parse_argument(int argc, char** argv, int index, int fallback, int minimum) {
+    int value;
+    char* end;
+
+    if (index >= argc) {return fallback;}
+
+    value = strtol(argv[index], &end, 10);
+    if (*end != '\0' || end == argv[index] || value < minimum) {
+        log_fatal("Expected integer argument of at least %d, got \"%s\"", minimum, argv[index]);
+    }
+    return value;
+}
+
+void bench_directory(bench_config* config, int file, char* buffer) {
+    int level, branch;
+
+    /* Files are spread over a tree of directories, BENCH_BRANCHING wide and depth deep */
+    strcpy(buffer, "src");
+    branch = file;
+    for (level = 0; level < config->depth; level++) {
+        sprintf(buffer + strlen(buffer), "/d%d_%d", level, branch % BENCH_BRANCHING);
+        branch /= BENCH_BRANCHING;
+    }
+}
+
+void bench_include(bench_config* config, int target, char* buffer) {
+    int level;
+    char directory[256];
+
+    buffer[0] = '\0';
+    for (level = 0; level < config->depth; level++) {
+        strcat(buffer, "../");
+    }
+
+    bench_directory(config, target, directory);
+    if (config->depth > 0) {
+        sprintf(buffer + strlen(buffer), "%s/", directory + strlen("src/"));
+    }
+    sprintf(buffer + strlen(buffer), "m%d.h", target);
+}
+
+int bench_include_taken(int* targets, int amount, int target) {
+    int i;
+
+    for (i = 0; i < amount; i++) {
+        if (targets[i] == target) {return 1;}
+    }
+    return 0;
+}
+
+void bench_generate(bench_config* config) {
+    int i, j, k;
+    char directory[256], path[512], include[512];
+    FILE *source, *header;
+
+    os_dir_make(config->root);
+    sprintf(path, "%s/src", config->root);
+    os_dir_make(path);
+
+    for (i = 0; i < config->files; i++) {
+        int* targets;
+
+        bench_directory(config, i, directory);
+        for (j = (int) strlen("src"); directory[j] != '\0'; j++) {
+            if (directory[j] != '/' || j == (int) strlen("src")) {continue;}
+            directory[j] = '\0';
+            sprintf(path, "%s/%s", config->root, directory);
+            os_dir_make(path);
+            directory[j] = '/';
+        }
+        sprintf(path, "%s/%s", config->root, directory);
+        os_dir_make(path);
+
+        sprintf(path, "%s/%s/m%d.h", config->root, directory, i);
+        header = fopen(path, "w");
+        sprintf(path, "%s/%s/m%d.c", config->root, directory, i);
+        source = fopen(path, "w");
+        if (header == NULL || source == NULL) {log_fatal("Could not generate \"%s\"", path);}
+
+        for (k = 0; k < config->symbols; k++) {
+            fprintf(header, "int m%d_s%d(int);\n", i, k);
+        }
+
+        /* The first include chains every file to the next, the rest are spread over the project */
+        targets = malloc(config->fanout * sizeof(int));
+        if (targets == NULL) {log_fatal("Could not allocate includes");}
+        fprintf(source, "#include \"m%d.h\"\n", i);
+        for (j = 0; j < config->fanout; j++) {
+            targets[j] = j == 0 ? (i + 1) % config->files : (i * 7 + j * 13 + 1) % config->files;
+            while (targets[j] == i || bench_include_taken(targets, j, targets[j])) {
+                targets[j] = (targets[j] + 1) % config->files;
+            }
+            bench_include(config, targets[j], include);
+            fprintf(source, "#include \"%s\"\n", include);
+        }
+
+        for (k = 0; k < config->symbols; k++) {
+            fprintf(source, "int m%d_s%d(int x) {\n", i, k);
+            fprintf(source, "    if (x <= 0) {return %d;}\n", k);
+            fprintf(source, "    return m%d_s%d(x - 1);\n", targets[k % config->fanout], k);
+            fprintf(source, "}\n");
+        }
+
+        free(targets);
+        fclose(header);
+        fclose(source);
+    }
+
+    sprintf(path, "%s/main.c", config->root);
+    source = fopen(path, "w");
+    if (source == NULL) {log_fatal("Could not generate main file");}
+    bench_directory(config, 0, directory);
+    fprintf(source, "#include \"%s/m0.h\"\n", directory);
+    fprintf(source, "int main(void) {return m0_s0(1);}\n");
+    fclose(source);
+}
+
+bld_path bench_root(bench_config* config) {
+    char cwd[FILENAME_MAX];
+    bld_path root;
+
+    if (!os_cwd(cwd, FILENAME_MAX)) {log_fatal("Could not get current directory");}
+    root = path_from_string(cwd);
+    path_append_string(&root, config->root);
+    return root;
+}
+
+bld_forward_project bench_forward_project(bld_path* root, bld_linker_type type) {
+    bld_path path;
+    bld_compiler compiler;
+    bld_linker linker;
+
+    path = path_copy(root);
+    compiler = compiler_new(BLD_COMPILER_GCC, "gcc");
+    linker = linker_new(type, "gcc");
+    return project_forward_new(&path, &compiler, &linker);
+}
+
+void bench_record(bench_phase* phases, int phase, uintmax_t start) {
+    uintmax_t elapsed;
+
+    elapsed = os_time_monotonic() - start;
+    if (phases[phase].total == 0 || elapsed < phases[phase].best) {
+        phases[phase].best = elapsed;
+    }
+    phases[phase].total += elapsed;
+}
+
+void bench_run(bld_path* root, bench_phase* phases, int timed) {
+    uintmax_t start;
+    bld_forward_project fproject;
+    bld_project project;
+
+    /* Each pass starts from fresh process state, the stat cache lives for one build */
+    os_stat_cache_start();
+    start = os_time_monotonic();
+    fproject = bench_forward_project(root, BLD_LINKER_GCC);
+    project_load_cache(&fproject, BENCH_CACHE);
+    project_set_main_file(&fproject, "main.c");
+    if (timed) {bench_record(phases, BENCH_LOAD_CACHE, start);}
+
+    start = os_time_monotonic();
+    project = project_resolve(&fproject);
+    if (timed) {bench_record(phases, BENCH_RESOLVE, start);}
+
+    if (timed) {
+        start = os_time_monotonic();
+        dependency_graph_extract_includes(&project.graph, &project.base, project.main_file, &project.files);
+        bench_record(phases, BENCH_EXTRACT_INCLUDES, start);
+
+        start = os_time_monotonic();
+        dependency_graph_extract_symbols(&project.graph, &project.base, project.main_file, &project.files);
+        bench_record(phases, BENCH_EXTRACT_SYMBOLS, start);
+
+        project_free(&project);
+        os_stat_cache_stop();
+
+        os_stat_cache_start();
+        fproject = bench_forward_project(root, BLD_LINKER_GCC);
+        project_load_cache(&fproject, BENCH_CACHE);
+        project_set_main_file(&fproject, "main.c");
+        project = project_resolve(&fproject);
+    }
+
+    start = os_time_monotonic();
+    if (incremental_compile_executable(&project, BENCH_EXECUTABLE) > 0) {
+        log_fatal("Could not compile generated project");
+    }
+    if (timed) {bench_record(phases, BENCH_NOOP_COMPILE, start);}
+
+    start = os_time_monotonic();
+    project_save_cache(&project);
+    if (timed) {bench_record(phases, BENCH_SAVE_CACHE, start);}
+
+    project_free(&project);
+    os_stat_cache_stop();
+}
+
+void bench_link(bench_config* config, bld_path* root, bld_linker_type type) {
+    int i;
+    char executable[256];
+    uintmax_t best, total;
+    bld_forward_project fproject;
+    bld_project project;
+
+    if (!linker_installed(type)) {
+        log_warn("%s is not installed, skipped link benchmark", string_unpack(linker_get_string(type)));
+        return;
+    }
+
+    /* Removing the executable forces a link, the objects are compiled by the earlier passes */
+    sprintf(executable, "%s/%s", config->root, BENCH_EXECUTABLE);
+    best = 0;
+    total = 0;
+    for (i = 0; i < BENCH_RUNS; i++) {
+        remove(executable);
+
+        os_stat_cache_start();
+        fproject = bench_forward_project(root, type);
+        project_load_cache(&fproject, BENCH_CACHE);
+        project_set_main_file(&fproject, "main.c");
+        project = project_resolve(&fproject);
+        if (incremental_compile_executable(&project, BENCH_EXECUTABLE) > 0) {
+            log_fatal("Could not link generated project with %s", string_unpack(linker_get_string(type)));
+        }
+
+        /* Link times are recorded in microseconds */
+        if (i == 0 || project.stats.link_time * 1000 < best) {best = project.stats.link_time * 1000;}
+        total += project.stats.link_time * 1000;
+
+        project_save_cache(&project);
+        project_free(&project);
+        os_stat_cache_stop();
+    }
+
+    printf("{\"bench\":\"phases\",\"phase\":\"link\",\"linker\":\"%s\",\"files\":%d,\"depth\":%d,\"fanout\":%d,\"symbols\":%d,\"runs\":%d,\"best_ns\":%lu,\"mean_ns\":%lu}\n",
+        string_unpack(linker_get_string(type)),
+        config->files,
+        config->depth,
+        config->fanout,
+        config->symbols,
+        BENCH_RUNS,
+        (unsigned long) best,
+        (unsigned long) (total / BENCH_RUNS)
+    );
+}
+
+int main(int argc, char** argv) {
+    int i;
+    bld_path root;
+    bench_config config;
+    bench_phase phases[BENCH_PHASES] = {
+        {"load_cache", 0, 0},
+        {"resolve", 0, 0},
+        {"extract_includes", 0, 0},
+        {"extract_symbols", 0, 0},
+        {"noop_compile", 0, 0},
+        {"save_cache", 0, 0}
+    };
+
+    config.files = bench_parse_argument(argc, argv, 1, 200, 2);
+    config.depth = bench_parse_argument(argc, argv, 2, 3, 0);
+    config.fanout = bench_parse_argument(argc, argv, 3, 4, 1);
+    config.symbols = bench_parse_argument(argc, argv, 4, 8, 1);
+    if (config.fanout >= config.files) {
+        log_fatal("Include fan-out has to be smaller than the amount of files");
+    }
+
+    /* Generation is deterministic, every configuration gets its own directory that later runs reuse */
+    sprintf(config.root, "bench_phases_%d_%d_%d_%d", config.files, config.depth, config.fanout, config.symbols);
+
+    set_log_level(BLD_WARN);
+    bench_generate(&config);
+    root = bench_root(&config);
+
+    /* The first pass compiles everything and fills the cache, the rest are warm no-op builds */
+    bench_run(&root, phases, 0);
+    for (i = 0; i < BENCH_RUNS; i++) {
+        bench_run(&root, phases, 1);
+    }
+
+    for (i = 0; i < BENCH_PHASES; i++) {
+        printf("{\"bench\":\"phases\",\"phase\":\"%s\",\"files\":%d,\"depth\":%d,\"fanout\":%d,\"symbols\":%d,\"runs\":%d,\"best_ns\":%lu,\"mean_ns\":%lu}\n",
+            phases[i].name,
+            config.files,
+            config.depth,
+            config.fanout,
+            config.symbols,
+            BENCH_RUNS,
+            (unsigned long) phases[i].best,
+            (unsigned long) (phases[i].total / BENCH_RUNS)
+        );
+    }
+
+    /* The default linker of the driver against the fast linkers, whichever are installed */
+    bench_link(&config, &root, BLD_LINKER_GCC);
+    bench_link(&config, &root, BLD_LINKER_MOLD);
+    bench_link(&config, &root, BLD_LINKER_LLD);
+
+    path_free(&root);
+    return 0;
+}
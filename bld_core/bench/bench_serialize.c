@@ -0,0 +1,131 @@
+/* Times project_save_cache on a synthetic project, link against the bld_core sources like the unit tests */
+#include <stdio.h>
+#include <stdlib.h>
+#include "../logging.h"
+#include "../os.h"
+#include "../project.h"
+#include "../json.h"
+
+#define BENCH_ROOT "bench_serialize"
+#define BENCH_FILES (500)
+#define BENCH_SYMBOLS (100)
+#define BENCH_RUNS (10)
+
+bld_project bench_project(void);
+void bench_add_symbols(bld_set*, size_t, char*);
+void bench_project_free(bld_project*);
+
+bld_project bench_project(void) {
+    int i;
+    char name[64];
+    FILE* source;
+    bld_path path, root_path, cache_root;
+    bld_linker linker;
+    bld_project project;
+    bld_file root, file;
+
+    os_dir_make(BENCH_ROOT);
+    path = path_from_string(BENCH_ROOT);
+    linker = linker_new(BLD_LINKER_GCC, "gcc");
+
+    root_path = path_from_string(".");
+    project.base.rebuilding = 0;
+    project.base.standalone = 1;
+    project.base.root = root_path;
+    project.base.linker = linker;
+    project.files = set_new(sizeof(bld_file));
+
+    cache_root = path_from_string(BENCH_ROOT);
+    project.base.cache.loaded = 1;
+    project.base.cache.set = 0;
+    project.base.cache.root = cache_root;
+    project.base.cache.builds = array_new(sizeof(bld_build_stats));
+    project.base.cache.link_fingerprint = 0;
+    project.base.cache.link_mtime = 0;
+    project.base.cache.build_recorded = 0;
+    project.base.cache.link_changed = 0;
+
+    root = file_directory_new(&path, &path, BENCH_ROOT);
+    project.root_dir = root.identifier.id;
+    project.main_file = BLD_INVALID_IDENITIFIER;
+
+    for (i = 0; i < BENCH_FILES; i++) {
+        bld_path file_path;
+
+        sprintf(name, "file_%d.c", i);
+        file_path = path_copy(&path);
+        path_append_string(&file_path, name);
+
+        source = fopen(path_to_string(&file_path), "w");
+        if (source == NULL) {log_fatal("Could not create \"%s\"", path_to_string(&file_path));}
+        fclose(source);
+
+        file = file_implementation_new(&file_path, &file_path, name);
+        file.compile_successful = 1;
+        file.identifier.hash = (uintmax_t) i * 2654435761u;
+        bench_add_symbols(&file.info.impl.defined_symbols, i, "defined");
+        bench_add_symbols(&file.info.impl.undefined_symbols, i, "undefined");
+        file_compile_times_push(&file, 1000000 + i);
+
+        file_dir_add_file(&root, &file);
+        set_add(&project.files, file.identifier.id, &file);
+    }
+    set_add(&project.files, root.identifier.id, &root);
+
+    return project;
+}
+
+void bench_add_symbols(bld_set* symbols, size_t file, char* kind) {
+    size_t i;
+    char name[128];
+    bld_string symbol;
+
+    for (i = 0; i < BENCH_SYMBOLS / 2; i++) {
+        sprintf(name, "bench_%s_symbol_%lu_%lu", kind, (unsigned long) file, (unsigned long) i);
+        symbol = string_new();
+        string_append_string(&symbol, name);
+        set_add(symbols, string_hash(name), &symbol);
+    }
+}
+
+void bench_project_free(bld_project* project) {
+    bld_iter iter;
+    bld_file* file;
+
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        file_free(file);
+    }
+    set_free(&project->files);
+
+    path_free(&project->base.root);
+    linker_free(&project->base.linker);
+    path_free(&project->base.cache.root);
+    array_free(&project->base.cache.builds);
+}
+
+int main(void) {
+    int i;
+    uintmax_t start, elapsed, best;
+    bld_project project;
+
+    project = bench_project();
+
+    best = 0;
+    for (i = 0; i < BENCH_RUNS; i++) {
+        start = os_time_monotonic();
+        project_save_cache(&project);
+        elapsed = os_time_monotonic() - start;
+        if (i == 0 || elapsed < best) {best = elapsed;}
+    }
+
+    printf("project_save_cache: %d files, %d symbols, best of %d: %.3f ms\n",
+        BENCH_FILES,
+        BENCH_FILES * BENCH_SYMBOLS,
+        BENCH_RUNS,
+        (double) best / 1e6
+    );
+
+    bench_project_free(&project);
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include <limits.h>
+#include "logging.h"
+#include "mem.h"
+#include "bitset.h"
+
+#define BLD_BITSET_WORD_BITS (sizeof(unsigned long) * CHAR_BIT)
+
+bld_bitset bitset_new(size_t size) {
+    bld_bitset bitset;
+
+    bitset.size = size;
+    bitset.words = mem_calloc(size / BLD_BITSET_WORD_BITS + 1, sizeof(unsigned long));
+    if (bitset.words == NULL) {log_fatal("bitset_new: could not allocate %lu bits", size);}
+    return bitset;
+}
+
+void bitset_free(bld_bitset* bitset) {
+    mem_free(bitset->words);
+}
+
+void bitset_set(bld_bitset* bitset, size_t index) {
+    if (index >= bitset->size) {log_fatal("bitset_set: index %lu out of bounds", index);}
+    bitset->words[index / BLD_BITSET_WORD_BITS] |= 1UL << (index % BLD_BITSET_WORD_BITS);
+}
+
+int bitset_test(const bld_bitset* bitset, size_t index) {
+    if (index >= bitset->size) {log_fatal("bitset_test: index %lu out of bounds", index);}
+    return (bitset->words[index / BLD_BITSET_WORD_BITS] >> (index % BLD_BITSET_WORD_BITS)) & 1;
+}
@@ -0,0 +1,15 @@
+#ifndef BITSET_H
+#define BITSET_H
+#include <stdlib.h>
+
+typedef struct bld_bitset {
+    size_t size;
+    unsigned long* words;
+} bld_bitset;
+
+bld_bitset  bitset_new(size_t);
+void        bitset_free(bld_bitset*);
+void        bitset_set(bld_bitset*, size_t);
+int         bitset_test(const bld_bitset*, size_t);
+
+#endif
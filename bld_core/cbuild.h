@@ -9,4 +9,5 @@
 #include "incremental.h"
 
 #include "rebuild.h"
+#include "trace.h"
 #endif
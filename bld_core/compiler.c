@@ -2,6 +2,7 @@
 #include <stdarg.h>
 #include "logging.h"
 #include "json.h"
+#include "hash.h"
 #include "compiler.h"
 
 bld_compiler compiler_new(bld_compiler_type type, char* executable) {
@@ -37,8 +38,8 @@ uintmax_t compiler_hash(bld_compiler* compiler) {
     uintmax_t seed;
 
     seed = 2349;
-    seed = (seed << 5) + string_hash(string_unpack(&compiler->executable));
-    seed = (seed << 5) + compiler_flags_hash(&compiler->flags);
+    seed = hash_combine(seed, string_hash(string_unpack(&compiler->executable)));
+    seed = hash_combine(seed, compiler_flags_hash(&compiler->flags));
 
     return seed;
 }
@@ -54,8 +55,11 @@ void compiler_remove_flag(bld_compiler* compiler, char* flag) {
 bld_compiler_flags compiler_flags_new(void) {
     bld_compiler_flags flags;
     flags.flags = array_new(sizeof(bld_string));
-    flags.flag_hash = set_new(0);
+    /* Holds the strings owned by flags, only to compare colliding keys */
+    flags.flag_hash = set_new(sizeof(bld_string));
+    set_verify_keys(&flags.flag_hash, string_key_eq);
     flags.removed = set_new(sizeof(bld_string));
+    set_verify_keys(&flags.removed, string_key_eq);
     return flags;
 }
 
@@ -90,6 +94,7 @@ bld_compiler_flags compiler_flags_copy(bld_compiler_flags* flags) {
     while (iter_next(&iter, (void**) &flag)) {
         bld_string temp = string_copy(flag);
         *flag = temp;
+        *(bld_string*) set_get(&cpy.flag_hash, string_hash(string_unpack(flag))) = temp;
     }
 
     iter = iter_set(&cpy.removed);
@@ -102,22 +107,24 @@ bld_compiler_flags compiler_flags_copy(bld_compiler_flags* flags) {
 }
 
 uintmax_t compiler_flags_hash(bld_compiler_flags* flags) {
-    uintmax_t seed;
+    uintmax_t seed, removed;
     bld_iter iter;
     bld_string* flag;
 
     seed = 2346;
     iter = iter_array(&flags->flags);
     while (iter_next(&iter, (void**) &flag)) {
-        seed = (seed << 5) + string_hash(string_unpack(flag));
+        seed = hash_combine(seed, string_hash(string_unpack(flag)));
     }
 
+    /* Removed flags are unordered, summing keeps the hash independent of the set layout */
+    removed = 0;
     iter = iter_set(&flags->removed);
     while (iter_next(&iter, (void**) &flag)) {
-        seed = (seed << 5) + string_hash(string_unpack(flag));
+        removed += string_hash(string_unpack(flag));
     }
 
-    return seed;
+    return hash_combine(seed, removed);
 }
 
 void compiler_flags_add_flag(bld_compiler_flags* flags, char* flag) {
@@ -128,12 +135,12 @@ void compiler_flags_add_flag(bld_compiler_flags* flags, char* flag) {
     temp = string_pack(flag);
     temp = string_copy(&temp);
 
-    if (set_has(&flags->removed, hash)) {
+    if (set_has_key(&flags->removed, hash, &temp)) {
         log_fatal(LOG_FATAL_PREFIX "trying to add flag \"%s\" which has already been removed by this set of flags", flag);
     }
 
     array_push(&flags->flags, &temp);
-    if (set_add(&flags->flag_hash, hash, NULL)) {
+    if (set_add(&flags->flag_hash, hash, &temp)) {
         log_fatal(LOG_FATAL_PREFIX "tried to add flag \"%s\" twice", flag);
     }
 }
@@ -145,7 +152,7 @@ void compiler_flags_remove_flag(bld_compiler_flags* flags, char* flag) {
     temp = string_pack(flag);
     hash = string_hash(flag);
 
-    if (set_has(&flags->flag_hash, hash)) {
+    if (set_has_key(&flags->flag_hash, hash, &temp)) {
         log_fatal(LOG_FATAL_PREFIX "trying to remove flag \"%s\" which has already been added by this set of flags", flag);
     }
 
@@ -216,35 +223,37 @@ void compiler_flags_expand(bld_string* cmd, bld_array* flags) {
 }
 
 void serialize_compiler(FILE* cache, bld_compiler* compiler, int depth) {
-    fprintf(cache, "{\n");
+    fputs("{\n", cache);
 
     json_serialize_key(cache, "type", depth);
-    fprintf(cache, "\"%s\"", string_unpack(compiler_get_string(compiler->type)));
-    fprintf(cache, ",\n");
+    json_serialize_string(cache, string_unpack(compiler_get_string(compiler->type)));
+    fputs(",\n", cache);
 
     json_serialize_key(cache, "executable", depth);
-    fprintf(cache, "\"%s\"", string_unpack(&compiler->executable));
-    fprintf(cache, ",\n");
+    json_serialize_string(cache, string_unpack(&compiler->executable));
+    fputs(",\n", cache);
 
     json_serialize_key(cache, "flags", depth);
     serialize_compiler_flags(cache, &compiler->flags, depth + 1);
 
-    fprintf(cache, "\n");
-    fprintf(cache, "%*c}", 2 * (depth - 1), ' ');
+    fputc('\n', cache);
+    json_serialize_indent(cache, 2 * (depth - 1));
+    fputc('}', cache);
 }
 
 void serialize_compiler_flags(FILE* cache, bld_compiler_flags* flags, int depth) {
-    fprintf(cache, "{\n");
+    fputs("{\n", cache);
 
     json_serialize_key(cache, "added", depth);
     serialize_compiler_flags_added_flags(cache, flags, depth + 1);
-    fprintf(cache, ",\n");
+    fputs(",\n", cache);
 
     json_serialize_key(cache, "removed", depth);
     serialize_compiler_flags_removed_flags(cache, flags, depth + 1);
 
-    fprintf(cache, "\n");
-    fprintf(cache, "%*c}", 2 * (depth - 1), ' ');
+    fputc('\n', cache);
+    json_serialize_indent(cache, 2 * (depth - 1));
+    fputc('}', cache);
 }
 
 void serialize_compiler_flags_added_flags(FILE* cache, bld_compiler_flags* flags, int depth) {
@@ -252,25 +261,26 @@ void serialize_compiler_flags_added_flags(FILE* cache, bld_compiler_flags* flags
     bld_iter iter;
     bld_string* flag;
 
-    fprintf(cache, "[");
+    fputc('[', cache);
     if (flags->flags.size > 1) {
-        fprintf(cache, "\n");
+        fputc('\n', cache);
     }
 
     iter = iter_array(&flags->flags);
     while (iter_next(&iter, (void**) &flag)) {
-        if (!first) {fprintf(cache, ",\n");}
+        if (!first) {fputs(",\n", cache);}
         else {first = 0;}
         if (flags->flags.size > 1) {
-            fprintf(cache, "%*c", 2 * depth, ' ');
+            json_serialize_indent(cache, 2 * depth);
         }
-        fprintf(cache, "\"%s\"", string_unpack(flag));
+        json_serialize_string(cache, string_unpack(flag));
     }
 
     if (flags->flags.size > 1) {
-        fprintf(cache, "\n%*c", 2 * (depth - 1), ' ');
+        fputc('\n', cache);
+        json_serialize_indent(cache, 2 * (depth - 1));
     }
-    fprintf(cache, "]");
+    fputc(']', cache);
 }
 
 void serialize_compiler_flags_removed_flags(FILE* cache, bld_compiler_flags* flags, int depth) {
@@ -278,25 +288,26 @@ void serialize_compiler_flags_removed_flags(FILE* cache, bld_compiler_flags* fla
     bld_iter iter;
     bld_string* flag;
 
-    fprintf(cache, "[");
+    fputc('[', cache);
     if (flags->removed.size > 1) {
-        fprintf(cache, "\n");
+        fputc('\n', cache);
     }
 
     iter = iter_set(&flags->removed);
     while (iter_next(&iter, (void**) &flag)) {
-        if (!first) {fprintf(cache, ",\n");}
+        if (!first) {fputs(",\n", cache);}
         else {first = 0;}
         if (flags->removed.size > 1) {
-            fprintf(cache, "%*c", 2 * (depth + 1), ' ');
+            json_serialize_indent(cache, 2 * (depth + 1));
         }
-        fprintf(cache, "\"%s\"", string_unpack(flag));
+        json_serialize_string(cache, string_unpack(flag));
     }
 
     if (flags->removed.size > 1) {
-        fprintf(cache, "\n%*c", 2 * depth, ' ');
+        fputc('\n', cache);
+        json_serialize_indent(cache, 2 * depth);
     }
-    fprintf(cache, "]");
+    fputc(']', cache);
 }
 
 int parse_compiler(FILE* file, bld_compiler* compiler) {
@@ -440,18 +451,18 @@ int parse_compiler_flags_added_flag(FILE* file, bld_compiler_flags* flags) {
     }
 
     hash = string_hash(string_unpack(&flag));
-    if (set_has(&flags->flag_hash, hash)) {
+    if (set_has_key(&flags->flag_hash, hash, &flag)) {
         log_warn("parse_compiler_flags_added_flag: duplicate flag, \"%s\"", string_unpack(&flag));
         goto parse_failed;
     }
 
-    if (set_has(&flags->removed, hash)) {
+    if (set_has_key(&flags->removed, hash, &flag)) {
         log_warn("parse_compiler_flags_added_flag: flag exists in both lists \"%s\"", string_unpack(&flag));
         goto parse_failed;
     }
 
     array_push(&flags->flags, &flag);
-    set_add(&flags->flag_hash, hash, NULL);
+    set_add(&flags->flag_hash, hash, &flag);
 
     return 0;
     parse_failed:
@@ -483,12 +494,12 @@ int parse_compiler_flags_removed_flag(FILE* file, bld_compiler_flags* flags) {
     }
 
     hash = string_hash(string_unpack(&flag));
-    if (set_has(&flags->flag_hash, hash)) {
+    if (set_has_key(&flags->flag_hash, hash, &flag)) {
         log_warn("parse_compiler_flags_removed_flag: flag exists in both lists, \"%s\"", string_unpack(&flag));
         goto parse_failed;
     }
 
-    if (set_has(&flags->removed, hash)) {
+    if (set_has_key(&flags->removed, hash, &flag)) {
         log_warn("parse_compiler_flags_removed_flag: duplicate flag \"%s\"", string_unpack(&flag));
         goto parse_failed;
     }
@@ -5,6 +5,7 @@
 extern bld_string bld_compiler_string_clang;
 
 int compile_to_object_clang(bld_string*, bld_string*, bld_path*, bld_path*);
+int compile_to_object_command_clang(bld_string*, bld_string*, bld_string*, bld_path*, bld_path*);
 int compiler_file_is_implementation_clang(bld_string*);
 int compiler_file_is_header_clang(bld_string*);
 bld_language_type compiler_file_language_clang(bld_string*);
@@ -121,6 +121,22 @@ int compile_to_object(bld_compiler_type type, bld_string* compiler, bld_string*
     return 0;
 }
 
+int compile_to_object_command(bld_compiler_type type, bld_string* cmd, bld_string* compiler, bld_string* flags, bld_path* file_path, bld_path* object_path) {
+    switch (type) {
+        case (BLD_COMPILER_GCC):
+            return compile_to_object_command_gcc(cmd, compiler, flags, file_path, object_path);
+        case (BLD_COMPILER_CLANG):
+            return compile_to_object_command_clang(cmd, compiler, flags, file_path, object_path);
+        case (BLD_COMPILER_ZIG):
+            return -1; /* zig has to be invoked from the object directory */
+        case (BLD_COMPILER_AMOUNT):
+            break;
+    }
+
+    log_fatal("compile_to_object_command: unknown type %d", type);
+    return 0;
+}
+
 int compiler_type_file_is_implementation(bld_compiler_type type, bld_string* name) {
     switch (type) {
         case (BLD_COMPILER_GCC):
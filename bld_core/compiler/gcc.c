@@ -8,6 +8,16 @@ int compile_to_object_gcc(bld_string* compiler, bld_string* flags, bld_path* fil
     int code;
     bld_string cmd;
 
+    compile_to_object_command_gcc(&cmd, compiler, flags, file_path, object_path);
+    code = system(string_unpack(&cmd));
+
+    string_free(&cmd);
+    return code;
+}
+
+int compile_to_object_command_gcc(bld_string* cmd_out, bld_string* compiler, bld_string* flags, bld_path* file_path, bld_path* object_path) {
+    bld_string cmd;
+
     cmd = string_copy(compiler);
     string_append_space(&cmd);
 
@@ -18,10 +28,8 @@ int compile_to_object_gcc(bld_string* compiler, bld_string* flags, bld_path* fil
     string_append_string(&cmd, " -c -o ");
     string_append_string(&cmd, path_to_string(object_path));
 
-    code = system(string_unpack(&cmd));
-
-    string_free(&cmd);
-    return code;
+    *cmd_out = cmd;
+    return 0;
 }
 
 /* TODO: verify list of file extensions gcc can take */
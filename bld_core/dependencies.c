@@ -2,18 +2,34 @@
 #include <ctype.h>
 #include <string.h>
 #include "logging.h"
+#include "trace.h"
+#include "mem.h"
+#include "index.h"
+#include "parallel.h"
 #include "graph.h"
 #include "dependencies.h"
 #include "language/language.h"
 
+typedef struct bld_dependency_work {
+    bld_project_base* base;
+    bld_file_id main_id;
+    bld_set* files;
+    bld_array* pending;
+} bld_dependency_work;
+
 void parse_included_files(bld_project_base*, bld_file_id, bld_file*, bld_set*);
 void parse_symbols(bld_project_base*, bld_file_id, bld_file*);
+void dependency_graph_includes_worker(void*, size_t, int);
+void dependency_graph_symbols_worker(void*, size_t, int);
 
 bld_dependency_graph dependency_graph_new(void) {
     bld_dependency_graph graph;
 
     graph.include_graph = graph_new();
     graph.symbol_graph = graph_new();
+    graph.index = graph_index_new();
+    graph.include_csr = graph_csr_new(&graph.include_graph, &graph.index);
+    graph.symbol_csr = graph_csr_new(&graph.symbol_graph, &graph.index);
 
     return graph;
 }
@@ -21,21 +37,38 @@ bld_dependency_graph dependency_graph_new(void) {
 void dependency_graph_free(bld_dependency_graph* graph) {
     graph_free(&graph->include_graph);
     graph_free(&graph->symbol_graph);
+    graph_index_free(&graph->index);
+    graph_csr_free(&graph->include_csr);
+    graph_csr_free(&graph->symbol_csr);
+}
+
+void dependency_graph_index_files(bld_dependency_graph* graph, bld_set* files) {
+    bld_iter iter;
+    bld_file* file;
+
+    /* Traversals work on dense indices, file identifiers are only looked up for visited files */
+    iter = iter_set(files);
+    while (iter_next(&iter, (void**) &file)) {
+        if (file->type == BLD_FILE_DIRECTORY) {continue;}
+        graph_index_add(&graph->index, file->identifier.id);
+    }
 }
 
 bld_iter dependency_graph_symbols_from(const bld_dependency_graph* graph, bld_file* root) {
-    return iter_graph(&graph->symbol_graph, root->identifier.id);
+    if (!graph_has_node(&graph->symbol_graph, root->identifier.id)) {log_fatal("root does not exist");}
+    return iter_graph_csr(&graph->symbol_csr, graph_index_get(&graph->index, root->identifier.id));
 }
 
 bld_iter dependency_graph_includes_from(const bld_dependency_graph* graph, bld_file* root) {
-    return  iter_graph(&graph->include_graph, root->identifier.id);
+    if (!graph_has_node(&graph->include_graph, root->identifier.id)) {log_fatal("root does not exist");}
+    return iter_graph_csr(&graph->include_csr, graph_index_get(&graph->index, root->identifier.id));
 }
 
 int dependency_graph_next_file(bld_iter* iter, const bld_set* files, bld_file** file) {
     uintmax_t file_id;
     int has_next;
     
-    has_next = graph_next(&iter->as.graph_iter, &file_id);
+    has_next = graph_csr_next(&iter->as.graph_csr_iter, &file_id);
     if (!has_next) {return has_next;}
 
     *file = set_get(files, file_id);
@@ -47,8 +80,16 @@ int dependency_graph_next_file(bld_iter* iter, const bld_set* files, bld_file**
 void dependency_graph_extract_includes(bld_dependency_graph* graph, bld_project_base* base, bld_file_id main_id, bld_set* files) {
     bld_iter iter;
     bld_file *file;
+    bld_array pending;
+    bld_dependency_work work;
+    uintmax_t span;
+    bld_mem_phase phase;
+
+    span = trace_begin();
+    phase = mem_phase(BLD_MEM_GRAPH);
     log_debug("Extracting includes, files in cache: %lu/%lu", graph->include_graph.edges.size, files->size);
 
+    pending = array_new(sizeof(bld_file*));
     iter = iter_set(files);
     while (iter_next(&iter, (void**) &file)) {
         if (file->type == BLD_FILE_DIRECTORY) {continue;}
@@ -58,9 +99,17 @@ void dependency_graph_extract_includes(bld_dependency_graph* graph, bld_project_
         }
         log_debug("Extracting includes of \"%s\"", string_unpack(&file->name));
         graph_add_node(&graph->include_graph, file->identifier.id);
-        parse_included_files(base, main_id, file, files);
+        array_push(&pending, &file);
     }
 
+    /* Workers only read the file set and fill the includes of their own file */
+    work.base = base;
+    work.main_id = main_id;
+    work.files = files;
+    work.pending = &pending;
+    parallel_for(pending.size, base->jobs, dependency_graph_includes_worker, &work);
+    array_free(&pending);
+
     iter = iter_set(files);
     while (iter_next(&iter, (void**) &file)) {
         bld_iter iter;
@@ -80,14 +129,27 @@ void dependency_graph_extract_includes(bld_dependency_graph* graph, bld_project_
         }
     }
 
+    graph_csr_free(&graph->include_csr);
+    graph->include_csr = graph_csr_new(&graph->include_graph, &graph->index);
+
     log_dinfo("Generated include graph with %lu nodes", graph->include_graph.edges.size);
+    mem_phase(phase);
+    trace_end(span, BLD_TRACE_PHASE, "extract includes", NULL, 0);
 }
 
 void dependency_graph_extract_symbols(bld_dependency_graph* graph, bld_project_base* base, bld_file_id main_id, bld_set* files) {
     bld_iter iter;
     bld_file* file;
+    bld_array pending;
+    bld_dependency_work work;
+    uintmax_t span;
+    bld_mem_phase phase;
+
+    span = trace_begin();
+    phase = mem_phase(BLD_MEM_GRAPH);
     log_debug("Extracting symbols, files in cache: %lu/%lu", graph->symbol_graph.edges.size, files->size);
 
+    pending = array_new(sizeof(bld_file*));
     iter = iter_set(files);
     while (iter_next(&iter, (void**) &file)) {
         if (file->type == BLD_FILE_DIRECTORY) {continue;}
@@ -100,10 +162,17 @@ void dependency_graph_extract_symbols(bld_dependency_graph* graph, bld_project_b
 
         log_debug("Extracting symbols of \"%s\"", string_unpack(&file->name));
         graph_add_node(&graph->symbol_graph, file->identifier.id);
-
-        parse_symbols(base, main_id, file);
+        array_push(&pending, &file);
     }
 
+    /* Workers only fill the symbol sets of their own file, edges are added below */
+    work.base = base;
+    work.main_id = main_id;
+    work.files = files;
+    work.pending = &pending;
+    parallel_for(pending.size, base->jobs, dependency_graph_symbols_worker, &work);
+    array_free(&pending);
+
     iter = iter_set(files);
     while (iter_next(&iter, (void**) &file)) {
         bld_iter iter;
@@ -127,7 +196,38 @@ void dependency_graph_extract_symbols(bld_dependency_graph* graph, bld_project_b
         }
     }
 
+    graph_csr_free(&graph->symbol_csr);
+    graph->symbol_csr = graph_csr_new(&graph->symbol_graph, &graph->index);
+
     log_dinfo("Generated symbol graph with %lu nodes", graph->symbol_graph.edges.size);
+    mem_phase(phase);
+    trace_end(span, BLD_TRACE_PHASE, "extract symbols", NULL, 0);
+}
+
+void dependency_graph_includes_worker(void* context, size_t index, int worker) {
+    bld_file* file;
+    bld_dependency_work* work;
+    (void)(worker);
+
+    work = context;
+    file = *(bld_file**) array_get(work->pending, index);
+
+    if (index_includes_get(file)) {return;}
+    parse_included_files(work->base, work->main_id, file, work->files);
+    index_includes_add(file);
+}
+
+void dependency_graph_symbols_worker(void* context, size_t index, int worker) {
+    uintmax_t job;
+    bld_file* file;
+    bld_dependency_work* work;
+
+    work = context;
+    file = *(bld_file**) array_get(work->pending, index);
+
+    job = trace_begin();
+    parse_symbols(work->base, work->main_id, file);
+    trace_end(job, BLD_TRACE_JOB, string_unpack(&file->name), path_to_string(&file->path), worker + 1);
 }
 
 void parse_symbols(bld_project_base* base, bld_file_id main_id, bld_file* file) {
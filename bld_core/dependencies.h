@@ -11,10 +11,14 @@
 typedef struct bld_dependency_graph {
     bld_graph include_graph;
     bld_graph symbol_graph;
+    bld_graph_index index;
+    bld_graph_csr include_csr;
+    bld_graph_csr symbol_csr;
 } bld_dependency_graph;
 
 bld_dependency_graph dependency_graph_new(void);
 void        dependency_graph_free(bld_dependency_graph*);
+void        dependency_graph_index_files(bld_dependency_graph*, bld_set*);
 
 void        dependency_graph_extract_includes(bld_dependency_graph*, bld_project_base*, bld_file_id, bld_set*);
 void        dependency_graph_extract_symbols(bld_dependency_graph*, bld_project_base*, bld_file_id, bld_set*);
@@ -1,15 +1,22 @@
+#if defined(__linux__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
 #include <string.h>
 #include "logging.h"
 #include "json.h"
+#include "hash.h"
+#include "mem.h"
 #include "dstr.h"
 
 int push_character(bld_string*, char);
+int reserve_characters(bld_string*, size_t);
+void append_characters(bld_string*, char*, size_t);
 
 bld_string string_new(void) {
     char* chars;
     bld_string str;
 
-    chars = calloc(1, 1);
+    chars = mem_calloc(1, 1);
     if (chars == NULL) {log_fatal(LOG_FATAL_PREFIX "could not allocate minimal string.");}
 
     str.capacity = 1;
@@ -32,7 +39,7 @@ bld_string string_copy(const bld_string* str) {
     char* chars;
     bld_string cpy;
 
-    chars = malloc(str->size + 1);
+    chars = mem_malloc(str->size + 1);
     if (chars == NULL) {
         log_fatal(LOG_FATAL_PREFIX "could not allocate copy of \"%s\".", str->chars);
     }
@@ -48,18 +55,11 @@ bld_string string_copy(const bld_string* str) {
 }
 
 void string_free(bld_string* str) {
-    free(str->chars);
+    mem_free(str->chars);
 }
 
 uintmax_t string_hash(char* str) {
-    uintmax_t seed;
-    char c;
-
-    seed = 5029;
-    while ((c = *str++) != '\0') {
-        seed = (seed << 5) + seed + c;
-    }
-    return seed;
+    return hash_bytes(str, strlen(str), 0);
 }
 
 int push_character(bld_string* str, char c) {
@@ -69,7 +69,7 @@ int push_character(bld_string* str, char c) {
     capacity = str->capacity;
     if (str->capacity == 0 || str->size >= str->capacity - 1) {
         capacity += (capacity / 2) + 2 * (capacity < 2);
-        chars = realloc(str->chars, capacity);
+        chars = mem_realloc(str->chars, capacity);
         if (chars == NULL) {
             return 0;
         }
@@ -84,11 +84,44 @@ int push_character(bld_string* str, char c) {
     return 1;
 }
 
+int reserve_characters(bld_string* str, size_t amount) {
+    size_t capacity;
+    char* chars;
+
+    if (str->size + amount < str->capacity) {return 1;}
+
+    capacity = str->capacity + str->capacity / 2 + 2;
+    if (capacity < str->size + amount + 1) {capacity = str->size + amount + 1;}
+
+    chars = mem_realloc(str->chars, capacity);
+    if (chars == NULL) {
+        return 0;
+    }
+
+    str->chars = chars;
+    str->capacity = capacity;
+    return 1;
+}
+
+void append_characters(bld_string* str, char* chars, size_t amount) {
+    if (!reserve_characters(str, amount)) {
+        log_fatal(LOG_FATAL_PREFIX "could not append %lu characters to string.", (unsigned long) amount);
+    }
+
+    memcpy(str->chars + str->size, chars, amount);
+    str->size += amount;
+    str->chars[str->size] = '\0';
+}
+
 int string_eq(const bld_string* str1, const bld_string* str2) {
     if (str1->size != str2->size) {return 0;}
     return strcmp(str1->chars, str2->chars) == 0;
 }
 
+int string_key_eq(const void* a, const void* b) {
+    return string_eq(a, b);
+}
+
 void string_append_space(bld_string* str) {
     if (!push_character(str, ' ')) {
         log_fatal(LOG_FATAL_PREFIX "could not append space to string.");
@@ -102,14 +135,13 @@ void string_append_char(bld_string* str, char c) {
 }
 
 void string_append_string(bld_string* str, char* s) {
-    char *temp, c;
+    size_t length;
 
-    temp = s;
-    while ((c = *temp++) != '\0') {
-        if (!push_character(str, c)) {
-            log_fatal(LOG_FATAL_PREFIX "could not append \"%s\" to string.", s);
-        }
+    length = strlen(s);
+    if (!reserve_characters(str, length)) {
+        log_fatal(LOG_FATAL_PREFIX "could not append \"%s\" to string.", s);
     }
+    append_characters(str, s, length);
 }
 
 char* string_unpack(const bld_string* str) {
@@ -117,6 +149,8 @@ char* string_unpack(const bld_string* str) {
 }
 
 int string_parse(FILE* file, bld_string* str) {
+    char buffer[256];
+    size_t amount;
     int c;
 
     c = next_character(file);
@@ -124,11 +158,17 @@ int string_parse(FILE* file, bld_string* str) {
     if (c != '\"') {log_warn("Expected string to start with \'\"\', got \'%c\'", c); goto parse_early_fail;}
 
     *str = string_new();
-    c = getc(file);
+    amount = 0;
+    c = json_getc(file);
     while (c != '\"' && c != EOF) {
-        string_append_char(str, c);
-        c = getc(file);
+        buffer[amount++] = c;
+        if (amount >= sizeof(buffer)) {
+            append_characters(str, buffer, amount);
+            amount = 0;
+        }
+        c = json_getc(file);
     }
+    append_characters(str, buffer, amount);
     if (c == EOF) {log_warn("Unexpected EOF"); goto parse_failed;}
 
     return 0;
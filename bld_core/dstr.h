@@ -20,6 +20,7 @@ char*       string_unpack(const bld_string*);
 void        string_free(bld_string*);
 uintmax_t   string_hash(char*);
 int         string_eq(const bld_string*, const bld_string*);
+int         string_key_eq(const void*, const void*);
 
 void        string_append_space(bld_string*);
 void        string_append_char(bld_string*, char);
@@ -5,6 +5,8 @@
 #include "logging.h"
 #include "iter.h"
 #include "linker.h"
+#include "index.h"
+#include "hash.h"
 #include "file.h"
 
 bld_file_identifier get_identifier(bld_path*);
@@ -16,10 +18,15 @@ void file_free_implementation(bld_file_implementation*);
 void file_free_interface(bld_file_interface*);
 void file_free_test(bld_file_test*);
 void file_determine_all_languages_under_recursive(bld_file*, bld_set*, bld_compiler*);
+void file_resolve_recursive(bld_file*, bld_set*, bld_set*, bld_file_id);
 
 bld_file_id file_get_id(bld_path* path) {
     bld_file_id id;
 
+    if (index_state.enabled) {
+        return get_identifier(path).id;
+    }
+
     id = os_info_id(path_to_string(path));
     if (id == BLD_INVALID_IDENITIFIER) {
         log_fatal(LOG_FATAL_PREFIX "could not extract information about \"%s\"", path_to_string(path));
@@ -30,20 +37,21 @@ bld_file_id file_get_id(bld_path* path) {
 
 bld_file_identifier get_identifier(bld_path* path) {
     bld_file_identifier identifier;
-    bld_file_id id;
-    bld_time mtime;
+    bld_os_stat info;
 
-    id = os_info_id(path_to_string(path));
-    mtime = os_info_mtime(path_to_string(path));
+    if (index_identifier_get(path, &identifier)) {
+        return identifier;
+    }
 
-    if (id == BLD_INVALID_IDENITIFIER) {
+    if (os_stat(path_to_string(path), &info) < 0) {
         log_fatal(LOG_FATAL_PREFIX "could not extract information about \"%s\"", path_to_string(path));
     }
 
-    identifier.id = id;
-    identifier.time = mtime; 
+    identifier.id = info.id;
+    identifier.time = info.mtime;
     identifier.hash = 0;
 
+    index_identifier_add(path, &identifier);
     return identifier;
 }
 
@@ -106,6 +114,9 @@ bld_file file_implementation_new(bld_path* total_path, bld_path* path, char* nam
     impl.info.impl.includes = set_new(sizeof(bld_path));
     impl.info.impl.defined_symbols = set_new(sizeof(bld_string));
     impl.info.impl.undefined_symbols = set_new(sizeof(bld_string));
+    set_verify_keys(&impl.info.impl.defined_symbols, string_key_eq);
+    set_verify_keys(&impl.info.impl.undefined_symbols, string_key_eq);
+    impl.info.impl.compile_times = array_new(sizeof(bld_time));
     return impl;
 }
 
@@ -114,6 +125,8 @@ bld_file file_test_new(bld_path* total_path, bld_path* path, char* name) {
     test = make_file(BLD_FILE_TEST, total_path, path, name);
     test.info.test.includes = set_new(sizeof(bld_path));
     test.info.test.undefined_symbols = set_new(sizeof(bld_string));
+    set_verify_keys(&test.info.test.undefined_symbols, string_key_eq);
+    test.info.test.compile_times = array_new(sizeof(bld_time));
     return test;
 }
 
@@ -171,6 +184,24 @@ bld_set* file_undefined_get(bld_file* file) {
     return NULL; /* unreachable */
 }
 
+bld_array* file_compile_times_get(bld_file* file) {
+    switch (file->type) {
+        case (BLD_FILE_DIRECTORY):
+            return NULL;
+        case (BLD_FILE_IMPLEMENTATION):
+            return &file->info.impl.compile_times;
+        case (BLD_FILE_TEST):
+            return &file->info.test.compile_times;
+        case (BLD_FILE_INTERFACE):
+            return NULL;
+        case (BLD_FILE_INVALID):
+            break;
+    }
+
+    log_fatal(LOG_FATAL_PREFIX "unrecognized file type %d", file->type);
+    return NULL; /* unreachable */
+}
+
 void file_free(bld_file* file) {
     file_free_base(file);
 
@@ -241,6 +272,8 @@ void file_free_implementation(bld_file_implementation* impl) {
         string_free(symbol);
     }
     set_free(&impl->defined_symbols);
+
+    array_free(&impl->compile_times);
 }
 
 void file_free_interface(bld_file_interface* header) {
@@ -270,19 +303,34 @@ void file_free_test(bld_file_test* test) {
         string_free(symbol);
     }
     set_free(&test->undefined_symbols);
+
+    array_free(&test->compile_times);
 }
 
-bld_hash file_hash(bld_file* file, bld_set* files) {
+bld_hash file_hash(bld_file* file, bld_file_resolution* resolution) {
     bld_hash seed;
-    bld_file_id parent_id;
 
     seed = 3401;
-    seed = (seed << 3) + file->identifier.id;
-    seed = (seed << 4) + seed + file->identifier.time;
+    seed = hash_combine(seed, file->identifier.id);
+    seed = hash_combine(seed, file->identifier.time);
+    seed = hash_combine(seed, resolution->compiler_hash);
+    seed = hash_combine(seed, resolution->linker_hash);
+    return seed;
+}
+
+bld_hash file_hash_compiler(bld_file* file, bld_set* files) {
+    bld_hash seed;
+    bld_iter iter;
+    bld_hash* hash;
+    bld_array hashes;
+    bld_file_id parent_id;
 
+    /* Collected upwards and combined from the root down, the same order as file_resolve_all_under */
+    hashes = array_new(sizeof(bld_hash));
     parent_id = file->identifier.id;
     while (parent_id != BLD_INVALID_IDENITIFIER) {
         bld_file* parent;
+        bld_hash temp;
 
         parent = set_get(files, parent_id);
         if (parent == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error, hashing compiler");}
@@ -291,26 +339,57 @@ bld_hash file_hash(bld_file* file, bld_set* files) {
 
         switch (parent->build_info.compiler.type) {
             case (BLD_COMPILER): {
-                seed = (seed << 3) + seed * compiler_hash(&parent->build_info.compiler.as.compiler);
+                temp = compiler_hash(&parent->build_info.compiler.as.compiler);
             } break;
             case (BLD_COMPILER_FLAGS): {
-                seed = (seed << 3) + seed * compiler_flags_hash(&parent->build_info.compiler.as.flags);
+                temp = compiler_flags_hash(&parent->build_info.compiler.as.flags);
             } break;
+            default: log_fatal(LOG_FATAL_PREFIX "internal error, hashing compiler");
         }
+        array_push(&hashes, &temp);
+    }
 
+    seed = 0;
+    array_reverse(&hashes);
+    iter = iter_array(&hashes);
+    while (iter_next(&iter, (void**) &hash)) {
+        seed = hash_combine(seed, *hash);
     }
 
+    array_free(&hashes);
+    return seed;
+}
+
+bld_hash file_hash_linker(bld_file* file, bld_set* files) {
+    bld_hash seed;
+    bld_iter iter;
+    bld_hash* hash;
+    bld_array hashes;
+    bld_file_id parent_id;
+
+    hashes = array_new(sizeof(bld_hash));
     parent_id = file->identifier.id;
     while (parent_id != BLD_INVALID_IDENITIFIER) {
         bld_file* parent;
+        bld_hash temp;
 
         parent = set_get(files, parent_id);
         if (parent == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error, hashing linker_flags");}
         parent_id = parent->parent_id;
         if (!parent->build_info.linker_set) {continue;}
 
-        seed = (seed << 3) + seed * linker_flags_hash(&parent->build_info.linker_flags);
+        temp = linker_flags_hash(&parent->build_info.linker_flags);
+        array_push(&hashes, &temp);
     }
+
+    seed = 0;
+    array_reverse(&hashes);
+    iter = iter_array(&hashes);
+    while (iter_next(&iter, (void**) &hash)) {
+        seed = hash_combine(seed, *hash);
+    }
+
+    array_free(&hashes);
     return seed;
 }
 
@@ -379,6 +458,35 @@ void file_symbols_copy(bld_file* file, bld_file* from) {
     no_copy_defined:;
 }
 
+void file_compile_times_copy(bld_file* file, bld_file* from) {
+    bld_array *times, *from_times;
+
+    if (file->type != from->type) {
+        log_fatal(LOG_FATAL_PREFIX "files do not have same type");
+    }
+
+    times = file_compile_times_get(file);
+    from_times = file_compile_times_get(from);
+    if (times == NULL || from_times == NULL) {return;}
+
+    array_free(times);
+    *times = array_copy(from_times);
+}
+
+void file_compile_times_push(bld_file* file, bld_time duration) {
+    bld_array* times;
+
+    times = file_compile_times_get(file);
+    if (times == NULL) {
+        log_fatal(LOG_FATAL_PREFIX "\"%s\" is not compiled and has no compile times", string_unpack(&file->name));
+    }
+
+    if (times->size >= BLD_FILE_COMPILE_HISTORY) {
+        array_remove(times, 0);
+    }
+    array_push(times, &duration);
+}
+
 bld_set file_copy_symbol_set(const bld_set* set) {
     bld_iter iter;
     bld_set cpy;
@@ -401,60 +509,6 @@ void file_dir_add_file(bld_file* dir, bld_file* file) {
     array_push(&dir->info.dir.files, &file->identifier.id);
 }
 
-void file_assemble_compiler(bld_file* file, bld_set* files, bld_compiler** compiler, bld_array* flags) {
-    bld_file_id parent_id;
-
-    parent_id = file->identifier.id;
-    *compiler = NULL;
-    *flags = array_new(sizeof(bld_compiler_flags));
-
-    while (parent_id != BLD_INVALID_IDENITIFIER) {
-        bld_file* parent;
-
-        parent = set_get(files, parent_id);
-        if (parent == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
-        parent_id = parent->parent_id;
-        if (!parent->build_info.compiler_set) {continue;}
-
-        if (parent->build_info.compiler.type == BLD_COMPILER) {
-            *compiler = &parent->build_info.compiler.as.compiler;
-            array_push(flags, &parent->build_info.compiler.as.compiler.flags);
-            break;
-        } else if (parent->build_info.compiler.type == BLD_COMPILER_FLAGS) {
-            array_push(flags, &parent->build_info.compiler.as.flags);
-        } else {
-            log_fatal(LOG_FATAL_PREFIX "internal error");
-        }
-    }
-
-    array_reverse(flags);
-
-    if (*compiler == NULL) {
-        log_fatal(LOG_FATAL_PREFIX "no compiler was encountered while assembling compiler associated with file, only compiler flags. Root has no associated compiler");
-    }
-}
-
-void file_assemble_linker_flags(bld_file* file, bld_set* files, bld_array* flags) {
-    bld_file_id parent_id;
-
-    parent_id = file->identifier.id;
-    *flags = array_new(sizeof(bld_linker_flags));
-
-    while (parent_id != BLD_INVALID_IDENITIFIER) {
-        bld_file* parent;
-
-        parent = set_get(files, parent_id);
-        if (parent == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
-
-        parent_id = parent->parent_id;
-        if (!parent->build_info.linker_set) {continue;}
-
-        array_push(flags, &parent->build_info.linker_flags);
-    }
-
-    array_reverse(flags);
-}
-
 void file_determine_all_languages_under(bld_file* file, bld_set* files) {
     bld_compiler* compiler;
 
@@ -492,3 +546,104 @@ void file_determine_all_languages_under_recursive(bld_file* file, bld_set* files
         }
     }
 }
+
+void file_resolve_all_under(bld_file* root, bld_set* files, bld_set* resolutions) {
+    file_resolve_recursive(root, files, resolutions, BLD_INVALID_IDENITIFIER);
+}
+
+void file_resolve_recursive(bld_file* file, bld_set* files, bld_set* resolutions, bld_file_id parent_id) {
+    bld_file_resolution resolution;
+    bld_file_resolution* parent;
+
+    /* Plain files share the resolution of their directory */
+    if (file->type != BLD_FILE_DIRECTORY && !file->build_info.compiler_set && !file->build_info.linker_set) {
+        return;
+    }
+
+    parent = NULL;
+    if (parent_id != BLD_INVALID_IDENITIFIER) {
+        parent = set_get(resolutions, parent_id);
+        if (parent == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
+    }
+
+    if (file->build_info.compiler_set && file->build_info.compiler.type == BLD_COMPILER) {
+        resolution.compiler = &file->build_info.compiler.as.compiler;
+        resolution.compiler_chain = array_new(sizeof(bld_compiler_flags));
+        array_push(&resolution.compiler_chain, &file->build_info.compiler.as.compiler.flags);
+    } else if (parent != NULL) {
+        resolution.compiler = parent->compiler;
+        resolution.compiler_chain = array_copy(&parent->compiler_chain);
+        if (file->build_info.compiler_set) {
+            array_push(&resolution.compiler_chain, &file->build_info.compiler.as.flags);
+        }
+    } else {
+        log_fatal(LOG_FATAL_PREFIX "no compiler was encountered while assembling compiler associated with file, only compiler flags. Root has no associated compiler");
+        return; /* unreachable */
+    }
+
+    resolution.compiler_flags = string_new();
+    compiler_flags_expand(&resolution.compiler_flags, &resolution.compiler_chain);
+
+    resolution.compiler_hash = parent == NULL ? 0 : parent->compiler_hash;
+    if (file->build_info.compiler_set) {
+        bld_hash hash;
+
+        if (file->build_info.compiler.type == BLD_COMPILER) {
+            hash = compiler_hash(&file->build_info.compiler.as.compiler);
+        } else {
+            hash = compiler_flags_hash(&file->build_info.compiler.as.flags);
+        }
+        resolution.compiler_hash = hash_combine(resolution.compiler_hash, hash);
+    }
+
+    resolution.linker_flags = string_new();
+    resolution.linker_hash = parent == NULL ? 0 : parent->linker_hash;
+    if (file->build_info.linker_set) {
+        linker_flags_append(&resolution.linker_flags, &file->build_info.linker_flags);
+        resolution.linker_hash = hash_combine(resolution.linker_hash, linker_flags_hash(&file->build_info.linker_flags));
+    }
+    if (parent != NULL) {
+        string_append_string(&resolution.linker_flags, string_unpack(&parent->linker_flags));
+    }
+
+    set_add(resolutions, file->identifier.id, &resolution);
+
+    if (file->type == BLD_FILE_DIRECTORY) {
+        bld_iter iter;
+        bld_file_id* sub_file_id;
+
+        iter = iter_array(&file->info.dir.files);
+        while (iter_next(&iter, (void**) &sub_file_id)) {
+            bld_file* sub_file;
+
+            sub_file = set_get(files, *sub_file_id);
+            if (sub_file == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
+            file_resolve_recursive(sub_file, files, resolutions, file->identifier.id);
+        }
+    }
+}
+
+bld_file_resolution* file_resolution_get(bld_file* file, bld_set* resolutions) {
+    bld_file_resolution* resolution;
+
+    resolution = set_get(resolutions, file->identifier.id);
+    if (resolution == NULL) {
+        resolution = set_get(resolutions, file->parent_id);
+    }
+    if (resolution == NULL) {log_fatal(LOG_FATAL_PREFIX "no resolution for \"%s\"", string_unpack(&file->name));}
+
+    return resolution;
+}
+
+void file_resolutions_free(bld_set* resolutions) {
+    bld_iter iter;
+    bld_file_resolution* resolution;
+
+    iter = iter_set(resolutions);
+    while (iter_next(&iter, (void**) &resolution)) {
+        array_free(&resolution->compiler_chain);
+        string_free(&resolution->compiler_flags);
+        string_free(&resolution->linker_flags);
+    }
+    set_free(resolutions);
+}
@@ -9,6 +9,8 @@
 #include "linker.h"
 #include "language/language_types.h"
 
+#define BLD_FILE_COMPILE_HISTORY (8)
+
 typedef uintmax_t bld_file_id;
 typedef uintmax_t bld_time;
 
@@ -41,6 +43,7 @@ typedef struct bld_file_implementation {
     bld_set includes;
     bld_set undefined_symbols;
     bld_set defined_symbols;
+    bld_array compile_times;
 } bld_file_implementation;
 
 typedef struct bld_file_interface {
@@ -50,6 +53,7 @@ typedef struct bld_file_interface {
 typedef struct bld_file_test {
     bld_set includes;
     bld_set undefined_symbols;
+    bld_array compile_times;
 } bld_file_test;
 
 typedef union bld_file_info {
@@ -71,6 +75,15 @@ typedef struct bld_file {
     bld_file_build_information build_info;
 } bld_file;
 
+typedef struct bld_file_resolution {
+    bld_compiler* compiler;
+    bld_array compiler_chain;
+    bld_string compiler_flags;
+    bld_hash compiler_hash;
+    bld_string linker_flags;
+    bld_hash linker_hash;
+} bld_file_resolution;
+
 bld_file    file_directory_new(bld_path*, bld_path*, char*);
 bld_file    file_interface_new(bld_path*, bld_path*, char*);
 bld_file    file_implementation_new(bld_path*, bld_path*, char*);
@@ -81,17 +94,23 @@ void        file_build_info_free(bld_file_build_information*);
 bld_set*    file_includes_get(bld_file*);
 bld_set*    file_defined_get(bld_file*);
 bld_set*    file_undefined_get(bld_file*);
-uintmax_t   file_hash(bld_file*, bld_set*);
+bld_array*  file_compile_times_get(bld_file*);
+uintmax_t   file_hash(bld_file*, bld_file_resolution*);
+bld_hash    file_hash_compiler(bld_file*, bld_set*);
+bld_hash    file_hash_linker(bld_file*, bld_set*);
 int         file_eq(bld_file*, bld_file*);
 uintmax_t   file_get_id(bld_path*);
 void        file_includes_copy(bld_file*, bld_file*);
 void        file_symbols_copy(bld_file*, bld_file*);
+void        file_compile_times_copy(bld_file*, bld_file*);
+void        file_compile_times_push(bld_file*, bld_time);
 bld_string  file_object_name(bld_file*);
 
 void        file_dir_add_file(bld_file*, bld_file*);
 
 void        file_determine_all_languages_under(bld_file*, bld_set*);
-void        file_assemble_compiler(bld_file*, bld_set*, bld_compiler**, bld_array*);
-void        file_assemble_linker_flags(bld_file*, bld_set*, bld_array*);
+void        file_resolve_all_under(bld_file*, bld_set*, bld_set*);
+bld_file_resolution* file_resolution_get(bld_file*, bld_set*);
+void        file_resolutions_free(bld_set*);
 
 #endif
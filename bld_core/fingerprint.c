@@ -0,0 +1,109 @@
+#include "logging.h"
+#include "iter.h"
+#include "hash.h"
+#include "fingerprint.h"
+
+void fingerprint_visit(bld_fingerprint_state*, bld_file*);
+void fingerprint_component(bld_fingerprint_state*, size_t);
+
+/* A file's fingerprint is its own hash combined with the fingerprints of
+ * everything it transitively includes, files on an include cycle share one */
+bld_set fingerprint_files(bld_set* files) {
+    bld_iter iter;
+    bld_file* file;
+    bld_set fingerprints;
+    bld_fingerprint_state state;
+
+    fingerprints = set_new(sizeof(bld_hash));
+    state.files = files;
+    state.fingerprints = &fingerprints;
+    state.nodes = set_new(sizeof(bld_fingerprint_node));
+    state.stack = array_new(sizeof(bld_file*));
+    state.next_index = 0;
+
+    iter = iter_set(files);
+    while (iter_next(&iter, (void**) &file)) {
+        if (file->type == BLD_FILE_DIRECTORY) {continue;}
+        if (set_has(&state.nodes, file->identifier.id)) {continue;}
+        fingerprint_visit(&state, file);
+    }
+
+    set_free(&state.nodes);
+    array_free(&state.stack);
+    return fingerprints;
+}
+
+void fingerprint_visit(bld_fingerprint_state* state, bld_file* file) {
+    size_t position;
+    bld_iter iter;
+    bld_path* path;
+    bld_file* included;
+    bld_fingerprint_node node, *self, *other;
+
+    node.index = state->next_index++;
+    node.low = node.index;
+    node.on_stack = 1;
+    set_add(&state->nodes, file->identifier.id, &node);
+
+    position = state->stack.size;
+    array_push(&state->stack, &file);
+
+    iter = iter_set(file_includes_get(file));
+    while (iter_next(&iter, (void**) &path)) {
+        bld_file_id id;
+
+        id = iter_set_key(&iter);
+        included = set_get(state->files, id);
+        if (included == NULL || included->type == BLD_FILE_DIRECTORY) {continue;}
+
+        if (!set_has(&state->nodes, id)) {
+            fingerprint_visit(state, included);
+            other = set_get(&state->nodes, id);
+            self = set_get(&state->nodes, file->identifier.id);
+            if (other->low < self->low) {self->low = other->low;}
+        } else {
+            other = set_get(&state->nodes, id);
+            self = set_get(&state->nodes, file->identifier.id);
+            if (other->on_stack && other->index < self->low) {self->low = other->index;}
+        }
+    }
+
+    /* The root of a component is the file entered first, the members lie above it on the stack */
+    self = set_get(&state->nodes, file->identifier.id);
+    if (self->low != self->index) {return;}
+    fingerprint_component(state, position);
+}
+
+void fingerprint_component(bld_fingerprint_state* state, size_t start) {
+    size_t i;
+    bld_hash own, external, fingerprint;
+    bld_iter iter;
+    bld_path* path;
+    bld_file* member;
+    bld_hash* included;
+    bld_fingerprint_node* node;
+
+    /* Sums keep the fingerprint independent of the iteration order of the sets */
+    own = 0;
+    external = 0;
+    for (i = start; i < state->stack.size; i++) {
+        member = *(bld_file**) array_get(&state->stack, i);
+        own += member->identifier.hash;
+
+        iter = iter_set(file_includes_get(member));
+        while (iter_next(&iter, (void**) &path)) {
+            included = set_get(state->fingerprints, iter_set_key(&iter));
+            if (included == NULL) {continue;}
+            external += *included;
+        }
+    }
+
+    fingerprint = hash_combine(own, external);
+    for (i = start; i < state->stack.size; i++) {
+        member = *(bld_file**) array_get(&state->stack, i);
+        node = set_get(&state->nodes, member->identifier.id);
+        node->on_stack = 0;
+        set_add(state->fingerprints, member->identifier.id, &fingerprint);
+    }
+    state->stack.size = start;
+}
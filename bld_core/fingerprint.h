@@ -0,0 +1,23 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+#include "set.h"
+#include "array.h"
+#include "file.h"
+
+typedef struct bld_fingerprint_node {
+    size_t index;
+    size_t low;
+    int on_stack;
+} bld_fingerprint_node;
+
+typedef struct bld_fingerprint_state {
+    bld_set* files;
+    bld_set* fingerprints;
+    bld_set nodes;
+    bld_array stack;
+    size_t next_index;
+} bld_fingerprint_state;
+
+bld_set     fingerprint_files(bld_set*);
+
+#endif
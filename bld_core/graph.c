@@ -1,4 +1,6 @@
+#include <string.h>
 #include "logging.h"
+#include "mem.h"
 #include "array.h"
 #include "graph.h"
 #include "iter.h"
@@ -39,3 +41,95 @@ void graph_add_edge(bld_graph* graph, uintmax_t from_id, uintmax_t to_id) {
 int graph_has_node(const bld_graph* graph, uintmax_t node_id) {
     return set_has(&graph->edges, node_id);
 }
+
+bld_graph_index graph_index_new(void) {
+    bld_graph_index index;
+
+    index.nodes = set_new(sizeof(bld_node));
+    index.ids = array_new(sizeof(uintmax_t));
+    return index;
+}
+
+void graph_index_free(bld_graph_index* index) {
+    set_free(&index->nodes);
+    array_free(&index->ids);
+}
+
+bld_node graph_index_add(bld_graph_index* index, uintmax_t id) {
+    bld_node node, *existing;
+
+    existing = set_get(&index->nodes, id);
+    if (existing != NULL) {return *existing;}
+
+    if (index->ids.size >= BLD_GRAPH_NO_NODE) {log_fatal("graph_index_add: too many nodes");}
+    node = (bld_node) index->ids.size;
+    set_add(&index->nodes, id, &node);
+    array_push(&index->ids, &id);
+    return node;
+}
+
+bld_node graph_index_get(const bld_graph_index* index, uintmax_t id) {
+    bld_node* node;
+
+    node = set_get(&index->nodes, id);
+    if (node == NULL) {return BLD_GRAPH_NO_NODE;}
+    return *node;
+}
+
+bld_graph_csr graph_csr_new(const bld_graph* graph, const bld_graph_index* index) {
+    bld_node i, from, *next;
+    bld_iter iter;
+    bld_array* edges;
+    bld_graph_csr csr;
+
+    csr.nodes = (bld_node) index->ids.size;
+    csr.offsets = mem_calloc((size_t) csr.nodes + 1, sizeof(bld_node));
+    csr.ids = mem_malloc(((size_t) csr.nodes + 1) * sizeof(uintmax_t));
+    if (csr.offsets == NULL || csr.ids == NULL) {log_fatal("graph_csr_new: could not allocate %lu nodes", (unsigned long) csr.nodes);}
+
+    for (i = 0; i < csr.nodes; i++) {
+        csr.ids[i] = *(uintmax_t*) array_get(&index->ids, i);
+    }
+
+    /* Count the edges of every node, then turn the counts into offsets */
+    iter = iter_set(&graph->edges);
+    while (iter_next(&iter, (void**) &edges)) {
+        from = graph_index_get(index, iter_set_key(&iter));
+        if (from == BLD_GRAPH_NO_NODE) {log_fatal("graph_csr_new: node has no index");}
+        csr.offsets[from + 1] = (bld_node) edges->size;
+    }
+    for (i = 0; i < csr.nodes; i++) {
+        csr.offsets[i + 1] += csr.offsets[i];
+    }
+
+    csr.targets = mem_malloc(((size_t) csr.offsets[csr.nodes] + 1) * sizeof(bld_node));
+    next = mem_malloc(((size_t) csr.nodes + 1) * sizeof(bld_node));
+    if (csr.targets == NULL || next == NULL) {log_fatal("graph_csr_new: could not allocate edges");}
+    memcpy(next, csr.offsets, ((size_t) csr.nodes + 1) * sizeof(bld_node));
+
+    /* Edges keep the order they were added in so traversals visit nodes in the same order */
+    iter = iter_set(&graph->edges);
+    while (iter_next(&iter, (void**) &edges)) {
+        bld_iter edge_iter;
+        uintmax_t* to_id;
+
+        from = graph_index_get(index, iter_set_key(&iter));
+        edge_iter = iter_array(edges);
+        while (iter_next(&edge_iter, (void**) &to_id)) {
+            bld_node to;
+
+            to = graph_index_get(index, *to_id);
+            if (to == BLD_GRAPH_NO_NODE) {log_fatal("graph_csr_new: edge target has no index");}
+            csr.targets[next[from]++] = to;
+        }
+    }
+
+    mem_free(next);
+    return csr;
+}
+
+void graph_csr_free(bld_graph_csr* csr) {
+    mem_free(csr->offsets);
+    mem_free(csr->targets);
+    mem_free(csr->ids);
+}
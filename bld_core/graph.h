@@ -1,15 +1,43 @@
 #ifndef GRAPH_H
 #define GRAPH_H
+#include <inttypes.h>
 #include "set.h"
+#include "array.h"
+
+#define BLD_GRAPH_NO_NODE ((bld_node) -1)
+
+typedef uint32_t bld_node;
 
 typedef struct bld_graph {
     bld_set edges;
 } bld_graph;
 
+/* Dense indices of the nodes of a graph, in the order they were added */
+typedef struct bld_graph_index {
+    bld_set nodes;
+    bld_array ids;
+} bld_graph_index;
+
+/* Compressed sparse row snapshot of a graph, the edges of node i are targets[offsets[i]..offsets[i + 1]] */
+typedef struct bld_graph_csr {
+    bld_node nodes;
+    bld_node* offsets;
+    bld_node* targets;
+    uintmax_t* ids;
+} bld_graph_csr;
+
 bld_graph   graph_new(void);
 void        graph_free(bld_graph*);
 void        graph_add_node(bld_graph*, uintmax_t);
 void        graph_add_edge(bld_graph*, uintmax_t, uintmax_t);
 int         graph_has_node(const bld_graph*, uintmax_t);
 
+bld_graph_index graph_index_new(void);
+void        graph_index_free(bld_graph_index*);
+bld_node    graph_index_add(bld_graph_index*, uintmax_t);
+bld_node    graph_index_get(const bld_graph_index*, uintmax_t);
+
+bld_graph_csr graph_csr_new(const bld_graph*, const bld_graph_index*);
+void        graph_csr_free(bld_graph_csr*);
+
 #endif
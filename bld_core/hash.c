@@ -0,0 +1,111 @@
+#include "hash.h"
+
+#define HASH_ROTATE(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+bld_hash hash_read_64(const unsigned char*);
+bld_hash hash_read_32(const unsigned char*);
+bld_hash hash_round(bld_hash, bld_hash);
+bld_hash hash_merge_round(bld_hash, bld_hash);
+bld_hash hash_avalanche(bld_hash);
+
+bld_hash hash_read_64(const unsigned char* bytes) {
+    return (bld_hash) bytes[0]
+        | (bld_hash) bytes[1] << 8
+        | (bld_hash) bytes[2] << 16
+        | (bld_hash) bytes[3] << 24
+        | (bld_hash) bytes[4] << 32
+        | (bld_hash) bytes[5] << 40
+        | (bld_hash) bytes[6] << 48
+        | (bld_hash) bytes[7] << 56;
+}
+
+bld_hash hash_read_32(const unsigned char* bytes) {
+    return (bld_hash) bytes[0]
+        | (bld_hash) bytes[1] << 8
+        | (bld_hash) bytes[2] << 16
+        | (bld_hash) bytes[3] << 24;
+}
+
+bld_hash hash_round(bld_hash accumulator, bld_hash input) {
+    accumulator += input * BLD_HASH_PRIME_2;
+    accumulator = HASH_ROTATE(accumulator, 31);
+    return accumulator * BLD_HASH_PRIME_1;
+}
+
+bld_hash hash_merge_round(bld_hash accumulator, bld_hash value) {
+    accumulator ^= hash_round(0, value);
+    return accumulator * BLD_HASH_PRIME_1 + BLD_HASH_PRIME_4;
+}
+
+bld_hash hash_avalanche(bld_hash hash) {
+    hash ^= hash >> 33;
+    hash *= BLD_HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= BLD_HASH_PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bld_hash hash_bytes(const void* data, size_t length, bld_hash seed) {
+    bld_hash hash;
+    const unsigned char* bytes;
+    const unsigned char* end;
+
+    bytes = data;
+    end = bytes + length;
+
+    if (length >= 32) {
+        bld_hash v1, v2, v3, v4;
+        const unsigned char* limit;
+
+        limit = end - 32;
+        v1 = seed + BLD_HASH_PRIME_1 + BLD_HASH_PRIME_2;
+        v2 = seed + BLD_HASH_PRIME_2;
+        v3 = seed;
+        v4 = seed - BLD_HASH_PRIME_1;
+
+        do {
+            v1 = hash_round(v1, hash_read_64(bytes)); bytes += 8;
+            v2 = hash_round(v2, hash_read_64(bytes)); bytes += 8;
+            v3 = hash_round(v3, hash_read_64(bytes)); bytes += 8;
+            v4 = hash_round(v4, hash_read_64(bytes)); bytes += 8;
+        } while (bytes <= limit);
+
+        hash = HASH_ROTATE(v1, 1) + HASH_ROTATE(v2, 7) + HASH_ROTATE(v3, 12) + HASH_ROTATE(v4, 18);
+        hash = hash_merge_round(hash, v1);
+        hash = hash_merge_round(hash, v2);
+        hash = hash_merge_round(hash, v3);
+        hash = hash_merge_round(hash, v4);
+    } else {
+        hash = seed + BLD_HASH_PRIME_5;
+    }
+
+    hash += (bld_hash) length;
+
+    while (bytes + 8 <= end) {
+        hash ^= hash_round(0, hash_read_64(bytes));
+        hash = HASH_ROTATE(hash, 27) * BLD_HASH_PRIME_1 + BLD_HASH_PRIME_4;
+        bytes += 8;
+    }
+
+    if (bytes + 4 <= end) {
+        hash ^= hash_read_32(bytes) * BLD_HASH_PRIME_1;
+        hash = HASH_ROTATE(hash, 23) * BLD_HASH_PRIME_2 + BLD_HASH_PRIME_3;
+        bytes += 4;
+    }
+
+    while (bytes < end) {
+        hash ^= (bld_hash) *bytes * BLD_HASH_PRIME_5;
+        hash = HASH_ROTATE(hash, 11) * BLD_HASH_PRIME_1;
+        bytes += 1;
+    }
+
+    return hash_avalanche(hash);
+}
+
+bld_hash hash_combine(bld_hash seed, bld_hash value) {
+    /* Mixes a single 64-bit lane into the seed, order of combination matters */
+    seed ^= hash_round(0, value);
+    seed = HASH_ROTATE(seed, 27) * BLD_HASH_PRIME_1 + BLD_HASH_PRIME_4;
+    return hash_avalanche(seed);
+}
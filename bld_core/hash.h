@@ -0,0 +1,17 @@
+#ifndef HASH_H
+#define HASH_H
+#include <stddef.h>
+#include "set.h"
+
+/* 64-bit hashing following XXH64, bld_hash is expected to be 64 bits wide */
+#define BLD_HASH_CONSTANT(high, low) (((bld_hash) (high) << 32) | (bld_hash) (low))
+#define BLD_HASH_PRIME_1 BLD_HASH_CONSTANT(0x9E3779B1, 0x85EBCA87)
+#define BLD_HASH_PRIME_2 BLD_HASH_CONSTANT(0xC2B2AE3D, 0x27D4EB4F)
+#define BLD_HASH_PRIME_3 BLD_HASH_CONSTANT(0x165667B1, 0x9E3779F9)
+#define BLD_HASH_PRIME_4 BLD_HASH_CONSTANT(0x85EBCA77, 0xC2B2AE63)
+#define BLD_HASH_PRIME_5 BLD_HASH_CONSTANT(0x27D4EB2F, 0x165667C5)
+
+bld_hash    hash_bytes(const void*, size_t, bld_hash);
+bld_hash    hash_combine(bld_hash, bld_hash);
+
+#endif
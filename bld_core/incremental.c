@@ -1,34 +1,84 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "os.h"
 #include "logging.h"
+#include "trace.h"
+#include "mem.h"
+#include "index.h"
+#include "hash.h"
+#include "fingerprint.h"
 #include "incremental.h"
 #include "linker/linker.h"
 
 void    incremental_make_root(bld_project*, bld_forward_project*);
 void    incremental_index_project(bld_project*, bld_forward_project*);
 void    incremental_index_possible_file(bld_project*, uintmax_t, bld_path*, bld_path*, char*);
-void    incremental_index_recursive(bld_project*, bld_forward_project*, uintmax_t, bld_path*, bld_path*, char*, int);
-void    incremental_apply_main_file(bld_project*, bld_forward_project*);
-void    incremental_apply_compilers(bld_project*, bld_forward_project*);
-void    incremental_apply_linker_flags(bld_project*, bld_forward_project*);
+void    incremental_index_recursive(bld_project*, bld_forward_project*, uintmax_t, bld_os_dir*, bld_path*, bld_path*, char*, int);
+bld_set incremental_index_names(bld_project*);
+void    incremental_index_names_free(bld_set*);
+int     incremental_find_files(bld_project*, bld_set*, bld_string*, bld_file**);
+void    incremental_apply_main_file(bld_project*, bld_forward_project*, bld_set*);
+void    incremental_apply_compilers(bld_project*, bld_forward_project*, bld_set*);
+void    incremental_apply_linker_flags(bld_project*, bld_forward_project*, bld_set*);
+
+typedef struct bld_compile_job {
+    bld_project* project;
+    bld_file* file;
+    int status;
+    int on_main_path;
+    bld_time estimate;
+    int slot;
+    uintmax_t start;
+    bld_os_process process;
+} bld_compile_job;
 
 int     incremental_compile_file(bld_project*, bld_file*);
+int     incremental_compile_command(bld_project*, bld_file*, bld_string*);
+void    incremental_compile_arguments(bld_project*, bld_file*, bld_compiler**, bld_string*, bld_path*, bld_path*);
 int     incremental_compile_with_absolute_path(bld_project*, char*);
+int     incremental_link_with_absolute_path(bld_project*, char*, int, int, uintmax_t);
+void    incremental_link_inputs(bld_project*, bld_array*, bld_array*);
+void    incremental_link_inputs_free(bld_array*, bld_array*);
+int     incremental_link_files(bld_project*, char*, bld_array*, bld_array*);
+bld_hash incremental_link_fingerprint(bld_project*, char*, bld_array*, bld_array*);
+uintmax_t incremental_modified(char*);
+bld_path incremental_executable_path(bld_project*, char*);
+bld_path incremental_object_path(bld_project*, bld_file*);
+
+void    incremental_record_build(bld_project*);
 
 void    incremental_mark_changed_files(bld_project*, bld_set*);
+int     incremental_fingerprint_equal(bld_project*, bld_set*, bld_file_id);
+bld_file_id incremental_explain_include(bld_project*, bld_set*, bld_set*, bld_file*);
 int     incremental_cached_compilation(bld_project*, bld_file*);
-int     incremental_compile_changed_files(bld_project*, bld_set*, int*);
+void    incremental_collect_project(bld_project*, bld_array*, int*);
+int     incremental_finish_project(bld_project*, bld_array*);
+void    incremental_collect_changed_files(bld_project*, bld_set*, bld_array*, int*);
+void    incremental_estimate_compile_jobs(bld_project*, bld_array*, size_t);
+int     incremental_compile_job_compare(const void*, const void*);
+bld_set incremental_main_symbol_closure(bld_project*);
+bld_set* incremental_known_symbols(bld_project*, bld_file*, int);
+void    incremental_run_compile_jobs(bld_array*, int);
+void    incremental_finish_compile_job(bld_compile_job*, int);
 
 bld_project project_resolve(bld_forward_project* fproject) {
     bld_project project;
+    bld_set names;
     bld_iter iter;
     bld_file* file;
+    uintmax_t span;
+    bld_mem_phase phase;
 
     project.base = fproject->base;
     project.files = set_new(sizeof(bld_file));
+    project.resolutions = set_new(sizeof(bld_file_resolution));
+    project.fingerprints = set_new(sizeof(bld_hash));
     project.graph = dependency_graph_new();
+    memset(&project.stats, 0, sizeof(bld_build_stats));
 
+    span = trace_begin();
+    phase = mem_phase(BLD_MEM_INDEX);
     incremental_make_root(&project, fproject);
 
     if (fproject->base.rebuilding) {
@@ -51,10 +101,15 @@ bld_project project_resolve(bld_forward_project* fproject) {
     }
 
     incremental_index_project(&project, fproject);
+    dependency_graph_index_files(&project.graph, &project.files);
+    trace_end(span, BLD_TRACE_PHASE, "index", NULL, 0);
 
-    incremental_apply_main_file(&project, fproject);
-    incremental_apply_compilers(&project, fproject);
-    incremental_apply_linker_flags(&project, fproject);
+    span = trace_begin();
+    names = incremental_index_names(&project);
+    incremental_apply_main_file(&project, fproject, &names);
+    incremental_apply_compilers(&project, fproject, &names);
+    incremental_apply_linker_flags(&project, fproject, &names);
+    incremental_index_names_free(&names);
 
     {
         bld_file* root;
@@ -65,19 +120,25 @@ bld_project project_resolve(bld_forward_project* fproject) {
         }
 
         file_determine_all_languages_under(root, &project.files);
+        file_resolve_all_under(root, &project.files, &project.resolutions);
     }
 
     iter = iter_set(&project.files);
     while (iter_next(&iter, (void**) &file)) {
-        file->identifier.hash = file_hash(file, &project.files);
+        file->identifier.hash = file_hash(file, file_resolution_get(file, &project.resolutions));
     }
+    trace_end(span, BLD_TRACE_PHASE, "resolve", NULL, 0);
 
     if (project.base.cache.set) {
+        span = trace_begin();
+        mem_phase(BLD_MEM_CACHE_LOAD);
         incremental_apply_cache(&project);
+        trace_end(span, BLD_TRACE_PHASE, "apply cache", NULL, 0);
     }
 
     fproject->resolved = 1;
     project_partial_free(fproject);
+    mem_phase(phase);
 
     return project;
 }
@@ -98,6 +159,9 @@ void incremental_apply_cache(bld_project* project) {
 
         cached = set_get(&project->base.cache.files, file->identifier.id);
         if (cached == NULL) {continue;}
+        if (file->type != cached->type) {continue;}
+
+        file_compile_times_copy(file, cached);
 
         if (file->identifier.hash != cached->identifier.hash) {continue;}
         file->compile_successful = 1;
@@ -168,32 +232,16 @@ void incremental_index_possible_file(bld_project* project, uintmax_t parent_id,
     file_dir_add_file(parent, temp);
 }
 
-void incremental_index_recursive(bld_project* project, bld_forward_project* forward_project, uintmax_t parent_id, bld_path* path, bld_path* relative_path, char* name, int adding_files) {
+void incremental_index_recursive(bld_project* project, bld_forward_project* forward_project, uintmax_t parent_id, bld_os_dir* dir, bld_path* path, bld_path* relative_path, char* name, int adding_files) {
     char *file_name;
     uintmax_t directory_id;
     bld_path new_path;
-    bld_os_dir* dir;
-    bld_os_file* file_ptr;
+    bld_iter iter;
+    bld_array names;
+    bld_string* entry;
 
-    if (adding_files) {
-        if (set_has(&forward_project->ignore_paths, file_get_id(path))) {
-            log_debug("Ignoring files under: \"%s\"", path_to_string(path));
-            adding_files = 0;
-        }
-    } else {
-        if (set_has(&forward_project->extra_paths, file_get_id(path))) {
-            log_debug("Adding files under: \"%s\"", path_to_string(path));
-            adding_files = 1;
-        }
-    }
-
-    dir = os_dir_open(path_to_string(path));
-    if (dir == NULL && adding_files) {
-        incremental_index_possible_file(project, parent_id, path, relative_path, name);
-        return;
-    } else if (dir == NULL && !adding_files) {
-        path_free(relative_path);
-        return;
+    if (index_directory(dir, path, &names)) {
+        names = array_new(sizeof(bld_string));
     }
 
     if (name == NULL) {
@@ -234,32 +282,74 @@ void incremental_index_recursive(bld_project* project, bld_forward_project* forw
         directory_id = parent_id;
     }
 
-    while ((file_ptr = os_dir_read(dir)) != NULL) {
+    iter = iter_array(&names);
+    while (iter_next(&iter, (void**) &entry)) {
+        int adding;
+        bld_os_stat info;
+        bld_os_dir* sub_dir;
         bld_path sub_path;
         bld_path temp;
+        bld_string packed_name;
 
-        file_name = os_file_name(file_ptr);
-        if (strcmp(file_name, ".") == 0 || strcmp(file_name, "..") == 0) {
-            continue;
+        file_name = string_unpack(entry);
+
+        /* Entries are resolved relative to the open directory instead of walking the full path again */
+        if (os_stat_at(dir, file_name, &info) < 0) {continue;}
+
+        adding = adding_files;
+        if (adding && set_has(&forward_project->ignore_paths, info.id)) {
+            adding = 0;
+        } else if (!adding && set_has(&forward_project->extra_paths, info.id)) {
+            adding = 1;
         }
-        if (file_name[0] == '.') {
+
+        if (info.type == BLD_OS_STAT_FILE) {
+            packed_name = string_pack(file_name);
+            if (!adding || strrchr(file_name, '.') == NULL || (
+                !compiler_file_is_implementation(&project->base.compiler_handles, &packed_name)
+                && !compiler_file_is_header(&project->base.compiler_handles, &packed_name)
+            )) {
+                continue;
+            }
+        } else if (info.type != BLD_OS_STAT_DIRECTORY) {
             continue;
         }
 
+        /* Paths are only built for the entries which are kept */
         sub_path = path_copy(path);
         path_append_string(&sub_path, file_name);
+        if (adding != adding_files) {
+            log_debug("%s files under: \"%s\"", adding ? "Adding" : "Ignoring", path_to_string(&sub_path));
+        }
+
+        os_stat_remember(path_to_string(&sub_path), &info);
         temp = path_copy(&new_path);
         path_append_string(&temp, file_name);
 
-        incremental_index_recursive(project, forward_project, directory_id, &sub_path, &temp, file_name, adding_files);
+        if (info.type == BLD_OS_STAT_FILE) {
+            incremental_index_possible_file(project, directory_id, &sub_path, &temp, file_name);
+            path_free(&sub_path);
+            continue;
+        }
+
+        sub_dir = os_dir_open_at(dir, file_name);
+        if (sub_dir == NULL) {
+            log_warn("Could not open directory \"%s\"", path_to_string(&sub_path));
+            path_free(&temp);
+            path_free(&sub_path);
+            continue;
+        }
+
+        incremental_index_recursive(project, forward_project, directory_id, sub_dir, &sub_path, &temp, file_name, adding);
 
+        os_dir_close(sub_dir);
         path_free(&sub_path);
     }
     
     if (name == NULL) {
         path_free(&new_path);
     }
-    os_dir_close(dir);
+    index_directory_free(&names);
 }
 
 void incremental_index_project(bld_project* project, bld_forward_project* forward_project) {
@@ -269,11 +359,11 @@ void incremental_index_project(bld_project* project, bld_forward_project* forwar
     path = path_copy(&project->base.root);
     dir = os_dir_open(path_to_string(&path));
     if (dir == NULL) {log_fatal("Could not open project root \"%s\"", path_to_string(&path));}
-    os_dir_close(dir);
 
     log_dinfo("Indexing project under root");
-    incremental_index_recursive(project, forward_project, project->root_dir, &path, NULL, NULL, 1);
+    incremental_index_recursive(project, forward_project, project->root_dir, dir, &path, NULL, NULL, !set_has(&forward_project->ignore_paths, file_get_id(&path)));
 
+    os_dir_close(dir);
     path_free(&path);
 }
 
@@ -298,13 +388,81 @@ void incremental_make_root(bld_project* project, bld_forward_project* fproject)
     if (exists) {log_fatal("incremental_make_root: root has already been initialized, has the project already been resolved?");}
 }
 
-void incremental_apply_main_file(bld_project* project, bld_forward_project* fproject) {
-    int match_found;
+bld_set incremental_index_names(bld_project* project) {
+    bld_iter iter;
+    bld_file* file;
+    bld_array* ids;
+    bld_set names;
+
+    names = set_new(sizeof(bld_array));
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        bld_hash hash;
+
+        hash = string_hash(string_unpack(&file->name));
+        ids = set_get(&names, hash);
+        if (ids == NULL) {
+            bld_array temp;
+
+            temp = array_new(sizeof(bld_file_id));
+            set_add(&names, hash, &temp);
+            ids = set_get(&names, hash);
+        }
+        array_push(ids, &file->identifier.id);
+    }
+
+    return names;
+}
+
+void incremental_index_names_free(bld_set* names) {
+    bld_iter iter;
+    bld_array* ids;
+
+    iter = iter_set(names);
+    while (iter_next(&iter, (void**) &ids)) {
+        array_free(ids);
+    }
+    set_free(names);
+}
+
+int incremental_find_files(bld_project* project, bld_set* names, bld_string* name, bld_file** match) {
+    int matches;
+    size_t start;
     bld_iter iter;
     bld_path path;
+    bld_array* ids;
+    bld_file_id* id;
+
+    /* Only files named like the last component of the rule can match, the rest of the rule is compared by suffix */
+    path.str = *name;
+    *match = NULL;
+    ids = set_get(names, string_hash(path_get_last_string(&path)));
+    if (ids == NULL) {return 0;}
+
+    matches = 0;
+    iter = iter_array(ids);
+    while (iter_next(&iter, (void**) &id)) {
+        bld_file* file;
+
+        file = set_get(&project->files, *id);
+        if (file == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
+        if (!path_ends_with(&file->path, &path)) {continue;}
+
+        start = file->path.str.size - path.str.size;
+        if (start > 0 && strncmp(&file->path.str.chars[start - 1], BLD_PATH_SEP, sizeof(BLD_PATH_SEP) - 1) != 0) {continue;}
+
+        matches += 1;
+        *match = file;
+    }
+
+    return matches;
+}
+
+void incremental_apply_main_file(bld_project* project, bld_forward_project* fproject, bld_set* names) {
+    int matches;
+    bld_path path;
     bld_file* file;
 
-    match_found = 0;
     path.str = fproject->main_file_name;
 
     if (fproject->base.rebuilding) {
@@ -312,23 +470,17 @@ void incremental_apply_main_file(bld_project* project, bld_forward_project* fpro
         return;
     }
 
-    iter = iter_set(&project->files);
-    while (iter_next(&iter, (void**) &file)) {
-        if (path_ends_with(&file->path, &path)) {
-            if (match_found) {
-                log_fatal("Name of main file \"%s\" is ambiguous, found several matches", string_unpack(&fproject->main_file_name));
-            }
-            match_found = 1;
-            project->main_file = file->identifier.id;
-        }
-    }
-
-    if (!match_found) {
+    matches = incremental_find_files(project, names, &fproject->main_file_name, &file);
+    if (matches > 1) {
+        log_fatal("Name of main file \"%s\" is ambiguous, found several matches", string_unpack(&fproject->main_file_name));
+    } else if (matches == 0) {
         log_fatal("No file matching \"%s\" could be found", string_unpack(&fproject->main_file_name));
     }
+
+    project->main_file = file->identifier.id;
 }
 
-void incremental_apply_compilers(bld_project* project, bld_forward_project* fproject) {
+void incremental_apply_compilers(bld_project* project, bld_forward_project* fproject, bld_set* names) {
     bld_iter name_iter, compiler_iter;
     bld_string* file_name;
     bld_compiler_or_flags* compiler;
@@ -340,30 +492,20 @@ void incremental_apply_compilers(bld_project* project, bld_forward_project* fpro
     name_iter = iter_array(&fproject->compiler_file_names);
     compiler_iter = iter_array(&fproject->file_compilers);
     while (iter_next(&name_iter, (void**) &file_name) && iter_next(&compiler_iter, (void**) &compiler)) {
-        int match_found;
-        bld_iter iter;
         bld_file* file;
-        bld_path path;
 
-        match_found = 0;
-        path = path_from_string(string_unpack(file_name));
-        iter = iter_set(&project->files);
-        while (iter_next(&iter, (void**) &file)) {
-            if (path_ends_with(&file->path, &path)) {
-                if (match_found) {
-                    log_fatal("Applying compiler to \"%s\" but several matches were found, specify more of path to determine exact match", string_unpack(file_name));
-                }
-                match_found = 1;
-                file->build_info.compiler_set = 1;
-                file->build_info.compiler = *compiler;
-            }
+        switch (incremental_find_files(project, names, file_name, &file)) {
+            case (0): continue;
+            case (1): break;
+            default: log_fatal("Applying compiler to \"%s\" but several matches were found, specify more of path to determine exact match", string_unpack(file_name));
         }
 
-        path_free(&path);
+        file->build_info.compiler_set = 1;
+        file->build_info.compiler = *compiler;
     }
 }
 
-void incremental_apply_linker_flags(bld_project* project, bld_forward_project* fproject) {
+void incremental_apply_linker_flags(bld_project* project, bld_forward_project* fproject, bld_set* names) {
     bld_iter name_iter, linker_flags_iter;
     bld_string* file_name;
     bld_linker_flags* flags;
@@ -375,83 +517,104 @@ void incremental_apply_linker_flags(bld_project* project, bld_forward_project* f
     name_iter = iter_array(&fproject->linker_flags_file_names);
     linker_flags_iter = iter_array(&fproject->file_linker_flags);
     while (iter_next(&name_iter, (void**) &file_name) && iter_next(&linker_flags_iter, (void**) &flags)) {
-        int match_found;
-        bld_iter iter;
         bld_file* file;
-        bld_path path;
 
-        match_found = 0;
-        path = path_from_string(string_unpack(file_name));
-        iter = iter_set(&project->files);
-        while (iter_next(&iter, (void**) &file)) {
-            if (path_ends_with(&file->path, &path)) {
-                if (match_found) {
-                    log_fatal("Applying linker flags to \"%s\" but several matches were found, specify more of path to determine exact match", string_unpack(file_name));
-                }
-                match_found = 1;
-                file->build_info.linker_set = 1;
-                file->build_info.linker_flags = *flags;
-            }
+        switch (incremental_find_files(project, names, file_name, &file)) {
+            case (0): continue;
+            case (1): break;
+            default: log_fatal("Applying linker flags to \"%s\" but several matches were found, specify more of path to determine exact match", string_unpack(file_name));
         }
 
-        path_free(&path);
+        file->build_info.linker_set = 1;
+        file->build_info.linker_flags = *flags;
     }
 }
 
 int incremental_compile_file(bld_project* project, bld_file* file) {
     int result;
-    bld_string flags, object_name;
+    bld_string flags;
     bld_compiler* compiler;
     bld_path file_path;
     bld_path object_path;
-    bld_array compiler_flags;
     log_info("Compiling: \"%s\"", string_unpack(&file->name));
 
-    file_assemble_compiler(file, &project->files, &compiler, &compiler_flags);
+    incremental_compile_arguments(project, file, &compiler, &flags, &file_path, &object_path);
+    result = compile_to_object(compiler->type, &compiler->executable, &flags, &file_path, &object_path);
+
+    path_free(&object_path);
+    path_free(&file_path);
+    string_free(&flags);
+    return result;
+}
 
-    flags = string_new();
-    compiler_flags_expand(&flags, &compiler_flags);
+int incremental_compile_command(bld_project* project, bld_file* file, bld_string* cmd) {
+    int result;
+    bld_string flags;
+    bld_compiler* compiler;
+    bld_path file_path;
+    bld_path object_path;
+
+    incremental_compile_arguments(project, file, &compiler, &flags, &file_path, &object_path);
+    result = compile_to_object_command(compiler->type, cmd, &compiler->executable, &flags, &file_path, &object_path);
+    if (!result) {
+        log_info("Compiling: \"%s\"", string_unpack(&file->name));
+    }
+
+    path_free(&object_path);
+    path_free(&file_path);
+    string_free(&flags);
+    return result;
+}
+
+void incremental_compile_arguments(bld_project* project, bld_file* file, bld_compiler** compiler, bld_string* flags, bld_path* file_path, bld_path* object_path) {
+    bld_file_resolution* resolution;
+
+    resolution = file_resolution_get(file, &project->resolutions);
+    *compiler = resolution->compiler;
+    *flags = string_copy(&resolution->compiler_flags);
 
     if (!project->base.rebuilding || file->identifier.id != project->main_file) {
-        file_path = path_copy(&project->base.root);
-    } else if (file->identifier.id == project->main_file) {
-        file_path = path_copy(&project->base.build_of->root);
+        *file_path = path_copy(&project->base.root);
+    } else {
+        *file_path = path_copy(&project->base.build_of->root);
     }
-    path_append_path(&file_path, &file->path);
+    path_append_path(file_path, &file->path);
 
-    object_path = path_copy(&project->base.root);
+    *object_path = incremental_object_path(project, file);
+}
+
+bld_path incremental_object_path(bld_project* project, bld_file* file) {
+    bld_string object_name;
+    bld_path path;
+
+    path = path_copy(&project->base.root);
     if (project->base.cache.loaded) {
-        path_append_path(&object_path, &project->base.cache.root);
+        path_append_path(&path, &project->base.cache.root);
     }
 
     object_name = file_object_name(file);
     string_append_string(&object_name, ".o");
-    path_append_string(&object_path, string_unpack(&object_name));
-
-    result = compile_to_object(compiler->type, &compiler->executable, &flags, &file_path, &object_path);
+    path_append_string(&path, string_unpack(&object_name));
 
-    path_free(&object_path);
-    path_free(&file_path);
     string_free(&object_name);
-    string_free(&flags);
-    array_free(&compiler_flags);
-    return result;
+    return path;
 }
 
 int incremental_link_executable(bld_project* project, char* executable_name) {
     int result;
-    bld_iter iter;
-    bld_path root;
     bld_array flags;
     bld_array files;
+
+    incremental_link_inputs(project, &files, &flags);
+    result = incremental_link_files(project, executable_name, &files, &flags);
+    incremental_link_inputs_free(&files, &flags);
+    return result;
+}
+
+void incremental_link_inputs(bld_project* project, bld_array* files, bld_array* flags) {
+    bld_iter iter;
     bld_file* main_file;
     bld_file* file;
-    bld_path executable;
-
-    root = path_copy(&project->base.root);
-    if (project->base.cache.loaded) {
-        path_append_path(&root, &project->base.cache.root);
-    }
 
     if (project->main_file == BLD_INVALID_IDENITIFIER) {
         log_fatal(LOG_FATAL_PREFIX "no main file set");
@@ -459,90 +622,253 @@ int incremental_link_executable(bld_project* project, char* executable_name) {
     main_file = set_get(&project->files, project->main_file);
     if (main_file == NULL) {
         log_fatal(LOG_FATAL_PREFIX "main file does not exist");
-        return -1; /* unreachable */
+        return; /* unreachable */
     }
 
-    flags = array_new(sizeof(bld_string));
-    files = array_new(sizeof(bld_file));
+    *flags = array_new(sizeof(bld_string));
+    *files = array_new(sizeof(bld_file));
 
     iter = dependency_graph_symbols_from(&project->graph, main_file);
     while (dependency_graph_next_file(&iter, &project->files, &file)) {
-        bld_array file_flags;
         bld_string f;
 
-        array_push(&files, file);
-
-        file_assemble_linker_flags(file, &project->files, &file_flags);
-        f = string_new();
-        linker_flags_expand(&f, &file_flags);
+        array_push(files, file);
 
-        array_push(&flags, &f);
-        array_free(&file_flags);
+        f = string_copy(&file_resolution_get(file, &project->resolutions)->linker_flags);
+        array_push(flags, &f);
     }
 
     {
         bld_string* last_flags;
 
-        last_flags = array_get(&flags, flags.size - 1);
+        last_flags = array_get(flags, flags->size - 1);
         linker_flags_append(last_flags, &project->base.linker.flags);
     }
+}
 
-    executable = path_from_string(executable_name);
-    result = linker_executable_make(project->base.linker.type, &project->base.linker.executable, &root, &files, &flags, &executable);
-    if (result < 0) {
-        log_fatal(LOG_FATAL_PREFIX "Expected return value of compiler to be non-negative.");
+void incremental_link_inputs_free(bld_array* files, bld_array* flags) {
+    bld_iter iter;
+    bld_string* file_flags;
+
+    iter = iter_array(flags);
+    while (iter_next(&iter, (void**) &file_flags)) {
+        string_free(file_flags);
     }
 
-    {
-        bld_string* file_flags;
+    array_free(flags);
+    array_free(files);
+}
 
-        iter = iter_array(&flags);
-        while (iter_next(&iter, (void**) &file_flags)) {
-            string_free(file_flags);
-        }
+int incremental_link_files(bld_project* project, char* executable_name, bld_array* files, bld_array* flags) {
+    int result;
+    bld_path root;
+    bld_path executable;
+
+    root = path_copy(&project->base.root);
+    if (project->base.cache.loaded) {
+        path_append_path(&root, &project->base.cache.root);
+    }
+
+    executable = path_from_string(executable_name);
+    result = linker_executable_make(project->base.linker.type, &project->base.linker.executable, &root, files, flags, &executable);
+    if (result < 0) {
+        log_fatal(LOG_FATAL_PREFIX "Expected return value of compiler to be non-negative.");
     }
 
     path_free(&root);
-    array_free(&flags);
-    array_free(&files);
     path_free(&executable);
     return result;
 }
 
+bld_hash incremental_link_fingerprint(bld_project* project, char* executable_name, bld_array* files, bld_array* flags) {
+    size_t i;
+    bld_hash fingerprint;
+    bld_file* file;
+    bld_path object;
+
+    /* Covers everything handed to the linker, in order, objects by their modification time */
+    fingerprint = hash_combine(linker_hash(&project->base.linker), string_hash(executable_name));
+    for (i = 0; i < files->size; i++) {
+        file = array_get(files, i);
+        object = incremental_object_path(project, file);
+
+        fingerprint = hash_combine(fingerprint, file->identifier.id);
+        fingerprint = hash_combine(fingerprint, incremental_modified(path_to_string(&object)));
+        fingerprint = hash_combine(fingerprint, string_hash(string_unpack(array_get(flags, i))));
+
+        path_free(&object);
+    }
+
+    return fingerprint == 0 ? 1 : fingerprint;
+}
+
+uintmax_t incremental_modified(char* path) {
+    bld_os_stat info;
+
+    if (os_stat(path, &info) < 0 || info.type == BLD_OS_STAT_MISSING) {return 0;}
+    return info.mtime_ns;
+}
+
 void incremental_mark_changed_files(bld_project* project, bld_set* changed_files) {
     int* has_changed;
-    bld_file *file, *cache_file, *temp;
     bld_iter iter;
+    bld_file* file;
+    bld_change* change;
+    bld_set changes;
+
+    changes = set_new(sizeof(bld_change));
+    incremental_explain_changed_files(project, &changes);
 
     iter = iter_set(&project->files);
     while (iter_next(&iter, (void**) &file)) {
-        bld_iter iter;
         if (file->type == BLD_FILE_DIRECTORY) {continue;}
 
+        change = set_get(&changes, file->identifier.id);
+        if (change->reason == BLD_CHANGE_NONE) {continue;}
+
         has_changed = set_get(changed_files, file->identifier.id);
         if (has_changed == NULL) {log_fatal("File did not exist in changed_files set");}
+        *has_changed = 1;
+    }
+
+    set_free(&changes);
+}
+
+void incremental_explain_changed_files(bld_project* project, bld_set* changes) {
+    bld_file *file, *cache_file;
+    bld_file_resolution* resolution;
+    bld_iter iter;
+    bld_change* change;
+    bld_set cached;
+
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        bld_change direct;
+        if (file->type == BLD_FILE_DIRECTORY) {continue;}
+
+        memset(&direct, 0, sizeof(bld_change));
+        direct.reason = BLD_CHANGE_NONE;
+        direct.include = BLD_INVALID_IDENITIFIER;
+
         if (!project->base.cache.set) {
-            *has_changed = 1;
+            direct.reason = BLD_CHANGE_NO_CACHE;
+            set_add(changes, file->identifier.id, &direct);
             continue;
         }
 
         cache_file = set_get(&project->base.cache.files, file->identifier.id);
 
         if (cache_file == NULL) {
-            *has_changed = 1;
+            direct.reason = BLD_CHANGE_NOT_CACHED;
         } else if (file->identifier.hash != cache_file->identifier.hash) {
-            *has_changed = 1;
-        } else {
-            continue;
+            direct.reason = BLD_CHANGE_HASH;
+            direct.mtime = file->identifier.time != cache_file->identifier.time;
+            resolution = file_resolution_get(file, &project->resolutions);
+            direct.compiler = resolution->compiler_hash != file_hash_compiler(cache_file, &project->base.cache.files);
+            direct.linker = resolution->linker_hash != file_hash_linker(cache_file, &project->base.cache.files);
         }
 
-        iter = dependency_graph_includes_from(&project->graph, file);
-        while (dependency_graph_next_file(&iter, &project->files, &temp)) {
-            has_changed = set_get(changed_files, temp->identifier.id);
-            if (has_changed == NULL) {log_fatal("incremental_mark_changed_files: unreachable error");}
-            *has_changed = 1;
+        set_add(changes, file->identifier.id, &direct);
+    }
+
+    set_free(&project->fingerprints);
+    project->fingerprints = fingerprint_files(&project->files);
+    if (!project->base.cache.set) {return;}
+
+    /* An unchanged file has to be rebuilt exactly when its fingerprint differs from the cached one */
+    cached = fingerprint_files(&project->base.cache.files);
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        if (file->type == BLD_FILE_DIRECTORY) {continue;}
+
+        change = set_get(changes, file->identifier.id);
+        if (change->reason != BLD_CHANGE_NONE) {continue;}
+        if (incremental_fingerprint_equal(project, &cached, file->identifier.id)) {continue;}
+
+        incremental_explain_include(project, changes, &cached, file);
+    }
+    set_free(&cached);
+}
+
+int incremental_fingerprint_equal(bld_project* project, bld_set* cached, bld_file_id id) {
+    bld_hash *current, *previous;
+
+    current = set_get(&project->fingerprints, id);
+    previous = set_get(cached, id);
+    if (current == NULL || previous == NULL) {return 0;}
+    return *current == *previous;
+}
+
+bld_file_id incremental_explain_include(bld_project* project, bld_set* changes, bld_set* cached, bld_file* file) {
+    bld_iter iter;
+    bld_path* path;
+    bld_file* included;
+    bld_change* change;
+
+    change = set_get(changes, file->identifier.id);
+    if (change == NULL) {log_fatal("incremental_explain_include: unreachable error");}
+    if (change->reason == BLD_CHANGE_INCLUDE) {return change->include;}
+    if (change->reason != BLD_CHANGE_NONE) {return file->identifier.id;}
+
+    /* Marked before descending, an include cycle then ends at a file already being explained */
+    change->reason = BLD_CHANGE_INCLUDE;
+    change->include = BLD_INVALID_IDENITIFIER;
+
+    iter = iter_set(file_includes_get(file));
+    while (iter_next(&iter, (void**) &path)) {
+        bld_file_id cause;
+
+        included = set_get(&project->files, iter_set_key(&iter));
+        if (included == NULL) {continue;}
+        if (incremental_fingerprint_equal(project, cached, included->identifier.id)) {continue;}
+
+        cause = incremental_explain_include(project, changes, cached, included);
+        if (cause == BLD_INVALID_IDENITIFIER) {continue;}
+
+        change = set_get(changes, file->identifier.id);
+        change->include = cause;
+        break;
+    }
+
+    change = set_get(changes, file->identifier.id);
+    return change->include;
+}
+
+bld_set incremental_explain_project(bld_project* project) {
+    bld_iter iter;
+    bld_file* file;
+    bld_change* change;
+    bld_set changes;
+
+    dependency_graph_extract_includes(&project->graph, &project->base, project->main_file, &project->files);
+
+    changes = set_new(sizeof(bld_change));
+    incremental_explain_changed_files(project, &changes);
+
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        if (file->type == BLD_FILE_INTERFACE || file->type == BLD_FILE_DIRECTORY) {continue;}
+
+        change = set_get(&changes, file->identifier.id);
+        if (change->reason != BLD_CHANGE_NONE) {continue;}
+
+        if (!incremental_object_exists(project, file)) {
+            change->reason = BLD_CHANGE_OBJECT_MISSING;
         }
     }
+
+    return changes;
+}
+
+int incremental_object_exists(bld_project* project, bld_file* file) {
+    int exists;
+    bld_path path;
+
+    path = incremental_object_path(project, file);
+    exists = os_file_exists(path_to_string(&path));
+
+    path_free(&path);
+    return exists;
 }
 
 
@@ -572,10 +898,23 @@ int incremental_cached_compilation(bld_project* project, bld_file* file) {
 
 int incremental_compile_with_absolute_path(bld_project* project, char* name) {
     int result;
-    int temp;
     int any_compiled;
+    uintmax_t start;
 
+    start = os_time_monotonic();
     result = incremental_compile_project(project, &any_compiled);
+    return incremental_link_with_absolute_path(project, name, result, any_compiled, start);
+}
+
+int incremental_link_with_absolute_path(bld_project* project, char* name, int result, int any_compiled, uintmax_t start) {
+    int temp;
+    int up_to_date;
+    uintmax_t span;
+    bld_hash fingerprint;
+    bld_array files, flags;
+    bld_project_cache* cache;
+    bld_mem_phase phase;
+
     if (result) {
         log_warn("Could not compile all files, no executable generated.");
         return result;
@@ -585,12 +924,54 @@ int incremental_compile_with_absolute_path(bld_project* project, char* name) {
         log_debug("Entire project existed in cache, generating executable");
     }
 
-    temp = incremental_link_executable(project, name);
+    span = os_time_monotonic();
+    phase = mem_phase(BLD_MEM_COMPILE);
+    cache = &project->base.cache;
+    incremental_link_inputs(project, &files, &flags);
+    fingerprint = incremental_link_fingerprint(project, name, &files, &flags);
+
+    /* The executable has to be the one written by the recorded link, not replaced or removed since */
+    up_to_date = cache->loaded
+        && cache->link_fingerprint == fingerprint
+        && cache->link_mtime != 0
+        && cache->link_mtime == incremental_modified(name);
+
+    if (up_to_date) {
+        log_debug("Executable \"%s\" is up to date, skipped linking", name);
+        temp = 0;
+    } else {
+        cache->link_fingerprint = 0;
+        cache->link_mtime = 0;
+        cache->link_changed = 1;
+
+        temp = incremental_link_files(project, name, &files, &flags);
+        os_stat_forget(name);
+        if (!temp && cache->loaded) {
+            cache->link_fingerprint = fingerprint;
+            cache->link_mtime = incremental_modified(name);
+        }
+    }
+
+    incremental_link_inputs_free(&files, &flags);
+    mem_phase(phase);
+    trace_end(span, BLD_TRACE_PHASE, up_to_date ? "link skipped" : "link", NULL, 0);
+    if (up_to_date) {
+        project->stats.link_time = 0;
+    } else {
+        project->stats.link_time = (os_time_monotonic() - span) / 1000;
+        project->stats.cpu_time += project->stats.link_time;
+    }
+    project->stats.wall_time = (os_time_monotonic() - start) / 1000;
+
     if (temp) {
         log_warn("Could not link final executable");
         result = temp;
+    } else if (up_to_date) {
+        log_info("Executable up to date: \"%s\"", name);
+        incremental_record_build(project);
     } else {
         log_info("Compiled executable: \"%s\"", name);
+        incremental_record_build(project);
     }
 
     if (!project->base.cache.loaded) {
@@ -612,6 +993,7 @@ int incremental_compile_with_absolute_path(bld_project* project, char* name) {
             string_append_string(&str, ".o");
 
             remove(string_unpack(&str));
+            os_stat_forget(string_unpack(&str));
             string_free(&str);
             string_free(&object_name);
         }
@@ -624,65 +1006,314 @@ int incremental_compile_with_absolute_path(bld_project* project, char* name) {
     }
 }
 
-int incremental_compile_changed_files(bld_project* project, bld_set* changed_files, int* any_compiled) {
-    int result;
+void incremental_record_build(bld_project* project) {
+    bld_array* builds;
+
+    if (!project->base.cache.loaded) {return;}
+
+    builds = &project->base.cache.builds;
+    if (builds->size >= BLD_BUILD_HISTORY) {
+        array_remove(builds, 0);
+    }
+    array_push(builds, &project->stats);
+    project->base.cache.build_recorded = 1;
+}
+
+void incremental_collect_changed_files(bld_project* project, bld_set* changed_files, bld_array* jobs, int* any_compiled) {
+    size_t first;
     bld_iter iter;
     bld_file* file;
 
-    result = 0;
+    first = jobs->size;
     iter = iter_set(&project->files);
     while (iter_next(&iter, (void**) &file)) {
-        int *has_changed, temp;
-        FILE* cached_file;
-        bld_string object_name;
-        bld_string compiled_path;
-        bld_path path;
+        int exists;
+        int *has_changed;
+        bld_compile_job job;
 
         if (file->type == BLD_FILE_INTERFACE || file->type == BLD_FILE_DIRECTORY) {continue;}
 
         has_changed = set_get(changed_files, file->identifier.id);
         if (has_changed == NULL) {log_fatal("incremental_compile_with_absolute_path: internal error");}
 
-        path = path_copy(&project->base.root);
-        if (project->base.cache.loaded) {
-            path_append_path(&path, &project->base.cache.root);
+        exists = incremental_object_exists(project, file);
+
+        if (!*has_changed && exists) {
+            project->stats.cached += 1;
+            continue;
+        }
+
+        if (!*has_changed && !exists) {
+            log_info("Cache is missing \"%s\", recompiling", string_unpack(&file->name));
         }
-        object_name = file_object_name(file);
-        path_append_string(&path, string_unpack(&object_name));
 
-        compiled_path = path.str;
-        string_append_string(&compiled_path, ".o");
+        *any_compiled = 1;
+        *has_changed = 0;
+
+        job.project = project;
+        job.file = file;
+        job.status = 0;
+        array_push(jobs, &job);
+    }
+
+    incremental_estimate_compile_jobs(project, jobs, first);
+}
 
-        cached_file = fopen(string_unpack(&compiled_path), "r");
-        if (cached_file != NULL) {fclose(cached_file);}
+void incremental_estimate_compile_jobs(bld_project* project, bld_array* jobs, size_t first) {
+    size_t i, known;
+    bld_time total, fallback;
+    bld_set closure;
+    bld_compile_job* job;
 
-        string_free(&object_name);
-        string_free(&compiled_path);
+    closure = incremental_main_symbol_closure(project);
 
-        if (!*has_changed && cached_file != NULL) {continue;}
+    known = 0;
+    total = 0;
+    for (i = first; i < jobs->size; i++) {
+        bld_array* times;
 
-        if (!*has_changed && cached_file == NULL) {
-            log_info("Cache is missing \"%s\", recompiling", string_unpack(&file->name));
+        job = array_get(jobs, i);
+
+        times = file_compile_times_get(job->file);
+        job->on_main_path = set_has(&closure, job->file->identifier.id);
+        job->estimate = 0;
+
+        if (times->size > 0) {
+            job->estimate = *(bld_time*) array_get(times, times->size - 1);
+            total += job->estimate;
+            known += 1;
         }
+    }
 
-        *any_compiled = 1;
-        *has_changed = 0;
-        temp = incremental_compile_file(project, file);
-        if (!temp) {
-            file->compile_successful = 1;
-        } else {
-            log_warn("Compiled \"%s\" with errors", string_unpack(&file->name));
-            file->compile_successful = 0;
-            result = temp;
+    /* Files without history are assumed to take an average amount of time */
+    fallback = known > 0 ? total / known : 0;
+    for (i = first; i < jobs->size; i++) {
+        job = array_get(jobs, i);
+        if (file_compile_times_get(job->file)->size == 0) {
+            job->estimate = fallback;
         }
     }
 
-    return result;
+    set_free(&closure);
+}
+
+int incremental_compile_job_compare(const void* a, const void* b) {
+    const bld_compile_job* j1 = a;
+    const bld_compile_job* j2 = b;
+
+    if (j1->on_main_path != j2->on_main_path) {
+        return j2->on_main_path - j1->on_main_path;
+    }
+
+    if (j1->estimate < j2->estimate) {
+        return 1;
+    } else if (j1->estimate > j2->estimate) {
+        return -1;
+    }
+    return 0;
+}
+
+bld_set incremental_main_symbol_closure(bld_project* project) {
+    bld_iter iter;
+    bld_file* file;
+    bld_set defined_by, closure;
+    bld_array stack;
+
+    defined_by = set_new(sizeof(bld_file_id));
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        bld_iter symbol_iter;
+        bld_set* defined;
+        bld_string* symbol;
+
+        defined = incremental_known_symbols(project, file, 1);
+        if (defined == NULL) {continue;}
+
+        symbol_iter = iter_set(defined);
+        while (iter_next(&symbol_iter, (void**) &symbol)) {
+            bld_hash hash;
+
+            /* Every main file defines main, the first definer is kept */
+            hash = string_hash(string_unpack(symbol));
+            if (set_has(&defined_by, hash)) {continue;}
+            set_add(&defined_by, hash, &file->identifier.id);
+        }
+    }
+
+    closure = set_new(0);
+    stack = array_new(sizeof(bld_file_id));
+    if (set_has(&project->files, project->main_file)) {
+        set_add(&closure, project->main_file, NULL);
+        array_push(&stack, &project->main_file);
+    }
+
+    while (stack.size > 0) {
+        bld_iter symbol_iter;
+        bld_set* undefined;
+        bld_string* symbol;
+        bld_file_id id;
+
+        id = *(bld_file_id*) array_pop(&stack);
+        file = set_get(&project->files, id);
+
+        undefined = incremental_known_symbols(project, file, 0);
+        if (undefined == NULL) {continue;}
+
+        symbol_iter = iter_set(undefined);
+        while (iter_next(&symbol_iter, (void**) &symbol)) {
+            bld_file_id* defining;
+
+            defining = set_get(&defined_by, string_hash(string_unpack(symbol)));
+            if (defining == NULL || set_has(&closure, *defining)) {continue;}
+
+            set_add(&closure, *defining, NULL);
+            array_push(&stack, defining);
+        }
+    }
+
+    array_free(&stack);
+    set_free(&defined_by);
+    return closure;
+}
+
+bld_set* incremental_known_symbols(bld_project* project, bld_file* file, int defined) {
+    bld_set* symbols;
+    bld_file* cached;
+
+    symbols = defined ? file_defined_get(file) : file_undefined_get(file);
+    if (symbols == NULL || symbols->size > 0 || !project->base.cache.set) {
+        return symbols;
+    }
+
+    /* Symbols of changed files are not known yet, use those of the previous build */
+    cached = set_get(&project->base.cache.files, file->identifier.id);
+    if (cached == NULL || cached->type != file->type) {
+        return symbols;
+    }
+    return defined ? file_defined_get(cached) : file_undefined_get(cached);
+}
+
+void incremental_run_compile_jobs(bld_array* jobs, int max_jobs) {
+    int running, slot;
+    size_t next;
+    uintmax_t span;
+    bld_compile_job* job;
+    bld_compile_job** slots;
+    bld_mem_phase phase;
+
+    span = trace_begin();
+    phase = mem_phase(BLD_MEM_COMPILE);
+    qsort(jobs->values, jobs->size, jobs->value_size, incremental_compile_job_compare);
+
+    max_jobs = max_jobs < 1 ? 1 : max_jobs;
+    slots = malloc(max_jobs * sizeof(bld_compile_job*));
+    if (slots == NULL) {log_fatal(LOG_FATAL_PREFIX "could not allocate job slots");}
+    for (slot = 0; slot < max_jobs; slot++) {
+        slots[slot] = NULL;
+    }
+
+    running = 0;
+    next = 0;
+    while (next < jobs->size || running > 0) {
+        int status;
+        bld_os_process process;
+
+        for (slot = 0; slot < max_jobs && next < jobs->size; slot++) {
+            bld_string cmd;
+
+            if (slots[slot] != NULL) {continue;}
+
+            job = array_get(jobs, next);
+            next += 1;
+
+            job->slot = slot;
+            job->start = os_time_monotonic();
+            if (incremental_compile_command(job->project, job->file, &cmd)) {
+                status = incremental_compile_file(job->project, job->file);
+                incremental_finish_compile_job(job, status);
+                continue;
+            }
+
+            if (os_process_start(string_unpack(&cmd), &job->process)) {
+                log_warn("Could not start compilation of \"%s\"", string_unpack(&job->file->name));
+                incremental_finish_compile_job(job, -1);
+            } else {
+                slots[slot] = job;
+                running += 1;
+            }
+            string_free(&cmd);
+        }
+
+        if (running == 0) {continue;}
+
+        if (os_process_wait(&process, &status)) {
+            log_fatal(LOG_FATAL_PREFIX "lost track of %d running compilation(s)", running);
+        }
+
+        for (slot = 0; slot < max_jobs; slot++) {
+            if (slots[slot] == NULL || slots[slot]->process != process) {continue;}
+
+            incremental_finish_compile_job(slots[slot], status);
+            slots[slot] = NULL;
+            running -= 1;
+            break;
+        }
+    }
+
+    free(slots);
+    mem_phase(phase);
+    trace_end(span, BLD_TRACE_PHASE, "compile", NULL, 0);
+}
+
+void incremental_finish_compile_job(bld_compile_job* job, int status) {
+    bld_time duration;
+    bld_project* project;
+    bld_file* file;
+    bld_path object_path;
+
+    project = job->project;
+    file = job->file;
+    job->status = status;
+
+    /* The compiler rewrote the object, drop what the stat cache knows about it */
+    object_path = incremental_object_path(project, file);
+    os_stat_forget(path_to_string(&object_path));
+    path_free(&object_path);
+
+    trace_end(job->start, BLD_TRACE_JOB, string_unpack(&file->name), path_to_string(&file->path), job->slot + 1);
+    duration = (os_time_monotonic() - job->start) / 1000;
+
+    project->stats.compiled += 1;
+    project->stats.cpu_time += duration;
+    if (duration > project->stats.longest_compile) {
+        project->stats.longest_compile = duration;
+    }
+    if (!status) {
+        file->compile_successful = 1;
+        file_compile_times_push(file, duration);
+    } else {
+        log_warn("Compiled \"%s\" with errors", string_unpack(&file->name));
+        file->compile_successful = 0;
+    }
 }
 
 int incremental_compile_project(bld_project* project, int* any_compiled) {
-    int temp;
     int result;
+    bld_array jobs;
+
+    jobs = array_new(sizeof(bld_compile_job));
+    incremental_collect_project(project, &jobs, any_compiled);
+    incremental_run_compile_jobs(&jobs, project->base.jobs);
+    result = incremental_finish_project(project, &jobs);
+
+    array_free(&jobs);
+    return result;
+}
+
+void incremental_collect_project(bld_project* project, bld_array* jobs, int* any_compiled) {
+    int temp;
+    uintmax_t span;
+    bld_mem_phase phase;
     bld_set changed_files;
     bld_file* file;
     bld_iter iter;
@@ -695,11 +1326,29 @@ int incremental_compile_project(bld_project* project, int* any_compiled) {
     }
 
     dependency_graph_extract_includes(&project->graph, &project->base, project->main_file, &project->files);
+
+    span = trace_begin();
+    phase = mem_phase(BLD_MEM_GRAPH);
     incremental_mark_changed_files(project, &changed_files);
+    mem_phase(phase);
+    trace_end(span, BLD_TRACE_PHASE, "mark changed", NULL, 0);
 
     *any_compiled = 0;
-    result = incremental_compile_changed_files(project, &changed_files, any_compiled);
+    incremental_collect_changed_files(project, &changed_files, jobs, any_compiled);
     set_free(&changed_files);
+}
+
+int incremental_finish_project(bld_project* project, bld_array* jobs) {
+    int result;
+    bld_iter iter;
+    bld_compile_job* job;
+
+    result = 0;
+    iter = iter_array(jobs);
+    while (iter_next(&iter, (void**) &job)) {
+        if (job->project != project) {continue;}
+        result |= job->status;
+    }
 
     dependency_graph_extract_symbols(&project->graph, &project->base, project->main_file, &project->files);
 
@@ -714,6 +1363,68 @@ int incremental_compile_executable(bld_project* project, char* name) {
     int result;
     bld_path executable_path;
 
+    executable_path = incremental_executable_path(project, name);
+    result = incremental_compile_with_absolute_path(project, path_to_string(&executable_path));
+
+    path_free(&executable_path);
+    return result;
+}
+
+int incremental_compile_executables(bld_array* projects, bld_array* names) {
+    int result, max_jobs;
+    size_t i;
+    uintmax_t start;
+    bld_array jobs, any_compiled;
+    bld_project* project;
+
+    if (projects->size != names->size) {
+        log_fatal(LOG_FATAL_PREFIX "got %lu projects but %lu executable names", projects->size, names->size);
+    }
+
+    start = os_time_monotonic();
+    jobs = array_new(sizeof(bld_compile_job));
+    any_compiled = array_new(sizeof(int));
+
+    max_jobs = 1;
+    for (i = 0; i < projects->size; i++) {
+        int compiled;
+
+        project = array_get(projects, i);
+        incremental_collect_project(project, &jobs, &compiled);
+        array_push(&any_compiled, &compiled);
+
+        if (project->base.jobs > max_jobs) {
+            max_jobs = project->base.jobs;
+        }
+    }
+
+    incremental_run_compile_jobs(&jobs, max_jobs);
+
+    result = 0;
+    for (i = 0; i < projects->size; i++) {
+        int temp;
+        bld_path executable_path;
+
+        project = array_get(projects, i);
+        executable_path = incremental_executable_path(project, string_unpack(array_get(names, i)));
+
+        temp = incremental_finish_project(project, &jobs);
+        temp = incremental_link_with_absolute_path(project, path_to_string(&executable_path), temp, *(int*) array_get(&any_compiled, i), start);
+        if (temp > 0) {
+            result = temp;
+        }
+
+        path_free(&executable_path);
+    }
+
+    array_free(&any_compiled);
+    array_free(&jobs);
+    return result;
+}
+
+bld_path incremental_executable_path(bld_project* project, char* name) {
+    bld_path executable_path;
+
     if (project->base.rebuilding) {
         executable_path = path_copy(&project->base.build_of->root);
     } else {
@@ -721,8 +1432,5 @@ int incremental_compile_executable(bld_project* project, char* name) {
     }
     path_append_string(&executable_path, name);
 
-    result = incremental_compile_with_absolute_path(project, path_to_string(&executable_path));
-
-    path_free(&executable_path);
-    return result;
+    return executable_path;
 }
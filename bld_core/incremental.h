@@ -1,11 +1,32 @@
 #ifndef INCREMENTAL_H
 #include "project.h"
 
+typedef enum bld_change_reason {
+    BLD_CHANGE_NONE,
+    BLD_CHANGE_NO_CACHE,
+    BLD_CHANGE_NOT_CACHED,
+    BLD_CHANGE_HASH,
+    BLD_CHANGE_INCLUDE,
+    BLD_CHANGE_OBJECT_MISSING
+} bld_change_reason;
+
+typedef struct bld_change {
+    bld_change_reason reason;
+    int mtime;
+    int compiler;
+    int linker;
+    bld_file_id include;
+} bld_change;
+
 bld_project project_resolve(bld_forward_project*);
 
 void    incremental_apply_cache(bld_project*);
 int     incremental_compile_project(bld_project*, int*);
 int     incremental_compile_executable(bld_project*, char*);
+int     incremental_compile_executables(bld_array*, bld_array*);
 int     incremental_link_executable(bld_project*, char*);
+bld_set incremental_explain_project(bld_project*);
+void    incremental_explain_changed_files(bld_project*, bld_set*);
+int     incremental_object_exists(bld_project*, bld_file*);
 
 #endif
@@ -0,0 +1,240 @@
+#include <string.h>
+#include "os.h"
+#include "iter.h"
+#include "logging.h"
+#include "index.h"
+
+void index_includes_copy(bld_set*, bld_set*);
+void index_includes_free(bld_set*);
+
+bld_index index_state = {0};
+
+void index_start(void) {
+    if (index_state.enabled) {
+        log_warn("Shared index already started");
+        return;
+    }
+
+    index_state.enabled = 1;
+    index_state.identifiers = set_new(sizeof(bld_file_identifier));
+    index_state.directories = set_new(sizeof(bld_index_directory));
+    index_state.includes = set_new(sizeof(bld_index_includes));
+    index_state.lock = os_mutex_new();
+}
+
+void index_stop(void) {
+    bld_iter iter;
+    bld_index_directory* directory;
+    bld_index_includes* includes;
+
+    if (!index_state.enabled) {return;}
+
+    iter = iter_set(&index_state.directories);
+    while (iter_next(&iter, (void**) &directory)) {
+        if (!directory->exists) {continue;}
+        index_directory_free(&directory->names);
+    }
+
+    iter = iter_set(&index_state.includes);
+    while (iter_next(&iter, (void**) &includes)) {
+        index_includes_free(&includes->includes);
+    }
+
+    set_free(&index_state.identifiers);
+    set_free(&index_state.directories);
+    set_free(&index_state.includes);
+    os_mutex_free(index_state.lock);
+    index_state.enabled = 0;
+}
+
+int index_identifier_get(bld_path* path, bld_file_identifier* identifier) {
+    bld_file_identifier* cached;
+
+    if (!index_state.enabled) {return 0;}
+
+    os_mutex_lock(index_state.lock);
+    cached = set_get(&index_state.identifiers, string_hash(path_to_string(path)));
+    if (cached != NULL) {
+        *identifier = *cached;
+    }
+    os_mutex_unlock(index_state.lock);
+
+    return cached != NULL;
+}
+
+void index_identifier_add(bld_path* path, bld_file_identifier* identifier) {
+    bld_hash hash;
+    bld_file_identifier* cached;
+
+    if (!index_state.enabled) {return;}
+
+    /* Include workers can resolve the same path at once, the first identifier is kept */
+    hash = string_hash(path_to_string(path));
+    os_mutex_lock(index_state.lock);
+    cached = set_get(&index_state.identifiers, hash);
+    if (cached == NULL) {
+        set_add(&index_state.identifiers, hash, identifier);
+    } else {
+        *identifier = *cached;
+    }
+    os_mutex_unlock(index_state.lock);
+}
+
+int index_directory(bld_os_dir* opened, bld_path* path, bld_array* names) {
+    bld_hash hash;
+    bld_iter iter;
+    bld_string* name;
+    bld_os_dir* dir;
+    bld_os_file* file_ptr;
+    bld_index_directory* cached;
+    bld_index_directory directory;
+
+    hash = string_hash(path_to_string(path));
+    if (index_state.enabled) {
+        int exists;
+
+        os_mutex_lock(index_state.lock);
+        cached = set_get(&index_state.directories, hash);
+        exists = cached != NULL && cached->exists;
+        if (exists) {
+            *names = array_new(sizeof(bld_string));
+            iter = iter_array(&cached->names);
+            while (iter_next(&iter, (void**) &name)) {
+                bld_string temp;
+
+                temp = string_copy(name);
+                array_push(names, &temp);
+            }
+        }
+        os_mutex_unlock(index_state.lock);
+
+        if (cached != NULL) {
+            return exists ? 0 : -1;
+        }
+    }
+
+    /* Reads from the already opened stream when given one, the path only names the listing */
+    dir = opened != NULL ? opened : os_dir_open(path_to_string(path));
+    directory.exists = dir != NULL;
+    if (dir == NULL) {
+        if (index_state.enabled) {
+            os_mutex_lock(index_state.lock);
+            set_add(&index_state.directories, hash, &directory);
+            os_mutex_unlock(index_state.lock);
+        }
+        return -1;
+    }
+
+    *names = array_new(sizeof(bld_string));
+    while ((file_ptr = os_dir_read(dir)) != NULL) {
+        bld_string temp;
+        char* file_name;
+
+        file_name = os_file_name(file_ptr);
+        if (file_name[0] == '.') {continue;}
+
+        temp = string_pack(file_name);
+        temp = string_copy(&temp);
+        array_push(names, &temp);
+    }
+    if (opened == NULL) {os_dir_close(dir);}
+
+    if (index_state.enabled) {
+        directory.names = array_new(sizeof(bld_string));
+        iter = iter_array(names);
+        while (iter_next(&iter, (void**) &name)) {
+            bld_string temp;
+
+            temp = string_copy(name);
+            array_push(&directory.names, &temp);
+        }
+
+        os_mutex_lock(index_state.lock);
+        if (set_add(&index_state.directories, hash, &directory)) {
+            index_directory_free(&directory.names);
+        }
+        os_mutex_unlock(index_state.lock);
+    }
+
+    return 0;
+}
+
+void index_directory_free(bld_array* names) {
+    bld_iter iter;
+    bld_string* name;
+
+    iter = iter_array(names);
+    while (iter_next(&iter, (void**) &name)) {
+        string_free(name);
+    }
+    array_free(names);
+}
+
+int index_includes_get(bld_file* file) {
+    bld_set* includes;
+    bld_index_includes* cached;
+
+    if (!index_state.enabled) {return 0;}
+
+    includes = file_includes_get(file);
+    if (includes == NULL) {return 0;}
+
+    os_mutex_lock(index_state.lock);
+    cached = set_get(&index_state.includes, file->identifier.id);
+    if (cached == NULL || cached->mtime != file->identifier.time) {
+        os_mutex_unlock(index_state.lock);
+        return 0;
+    }
+
+    index_includes_free(includes);
+    index_includes_copy(includes, &cached->includes);
+    os_mutex_unlock(index_state.lock);
+    return 1;
+}
+
+void index_includes_add(bld_file* file) {
+    bld_set* includes;
+    bld_index_includes entry;
+    bld_index_includes* cached;
+
+    if (!index_state.enabled) {return;}
+
+    includes = file_includes_get(file);
+    if (includes == NULL) {return;}
+
+    os_mutex_lock(index_state.lock);
+    cached = set_get(&index_state.includes, file->identifier.id);
+    if (cached != NULL) {
+        index_includes_free(&cached->includes);
+        cached->mtime = file->identifier.time;
+        index_includes_copy(&cached->includes, includes);
+    } else {
+        entry.mtime = file->identifier.time;
+        index_includes_copy(&entry.includes, includes);
+        set_add(&index_state.includes, file->identifier.id, &entry);
+    }
+    os_mutex_unlock(index_state.lock);
+}
+
+void index_includes_copy(bld_set* includes, bld_set* from) {
+    bld_iter iter;
+    bld_path* path;
+
+    *includes = set_copy(from);
+
+    iter = iter_set(includes);
+    while (iter_next(&iter, (void**) &path)) {
+        *path = path_copy(path);
+    }
+}
+
+void index_includes_free(bld_set* includes) {
+    bld_iter iter;
+    bld_path* path;
+
+    iter = iter_set(includes);
+    while (iter_next(&iter, (void**) &path)) {
+        path_free(path);
+    }
+    set_free(includes);
+}
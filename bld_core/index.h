@@ -0,0 +1,41 @@
+#ifndef INDEX_H
+#define INDEX_H
+#include "os.h"
+#include "array.h"
+#include "set.h"
+#include "path.h"
+#include "file.h"
+
+typedef struct bld_index_directory {
+    int exists;
+    bld_array names;
+} bld_index_directory;
+
+typedef struct bld_index_includes {
+    bld_time mtime;
+    bld_set includes;
+} bld_index_includes;
+
+typedef struct bld_index {
+    int enabled;
+    bld_set identifiers;
+    bld_set directories;
+    bld_set includes;
+    bld_os_mutex* lock;
+} bld_index;
+
+extern bld_index index_state;
+
+void    index_start(void);
+void    index_stop(void);
+
+int     index_identifier_get(bld_path*, bld_file_identifier*);
+void    index_identifier_add(bld_path*, bld_file_identifier*);
+
+int     index_directory(bld_os_dir*, bld_path*, bld_array*);
+void    index_directory_free(bld_array*);
+
+int     index_includes_get(bld_file*);
+void    index_includes_add(bld_file*);
+
+#endif
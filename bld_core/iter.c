@@ -63,6 +63,13 @@ int set_next(bld_iter_set* iter, void** value_ptr_ptr) {
     return has_next;
 }
 
+bld_hash iter_set_key(const bld_iter* iter) {
+    if (iter->type != BLD_SET || iter->as.set_iter.index == 0) {
+        log_fatal("iter_set_key: iterator has not produced a set value");
+    }
+    return iter->as.set_iter.set->hash[iter->as.set_iter.index - 1];
+}
+
 bld_iter iter_graph(const bld_graph* graph, uintmax_t root) {
     bld_iter iter;
 
@@ -130,6 +137,50 @@ int graph_next(bld_iter_graph* iter, uintmax_t* node_id) {
     return 1;
 }
 
+bld_iter iter_graph_csr(const bld_graph_csr* csr, bld_node root) {
+    bld_iter iter;
+
+    if (root >= csr->nodes) {log_fatal("root does not exist");}
+
+    iter.type = BLD_GRAPH_CSR;
+    iter.as.graph_csr_iter.type = BLD_DFS;
+    iter.as.graph_csr_iter.csr = csr;
+    iter.as.graph_csr_iter.stack = array_new(sizeof(bld_node));
+    iter.as.graph_csr_iter.visited = bitset_new(csr->nodes);
+    array_push(&iter.as.graph_csr_iter.stack, &root);
+
+    return iter;
+}
+
+int graph_csr_next(bld_iter_graph_csr* iter, uintmax_t* node_id) {
+    bld_node node, edge;
+    const bld_graph_csr* csr;
+
+    if (iter->type == BLD_GRAPH_DONE) {
+        return 0;
+    }
+
+    /* Same visiting order as graph_next, edges are pushed in order and the last one is taken first */
+    csr = iter->csr;
+    do {
+        if (iter->stack.size <= 0) {
+            iter->type = BLD_GRAPH_DONE;
+            array_free(&iter->stack);
+            bitset_free(&iter->visited);
+            return 0;
+        }
+        node = *(bld_node*) array_pop(&iter->stack);
+    } while (bitset_test(&iter->visited, node));
+
+    bitset_set(&iter->visited, node);
+    for (edge = csr->offsets[node]; edge < csr->offsets[node + 1]; edge++) {
+        array_push(&iter->stack, &csr->targets[edge]);
+    }
+
+    *node_id = csr->ids[node];
+    return 1;
+}
+
 bld_iter iter_directory(bld_os_dir* dir) {
     bld_iter iter;
     if (dir == NULL) {log_fatal("iter_directory: directory to traverse is null");}
@@ -162,6 +213,9 @@ int iter_next(bld_iter* iter, void** value_ptr_ptr) {
         case (BLD_GRAPH): {
             return graph_next(&iter->as.graph_iter, (uintmax_t*) value_ptr_ptr);
         } break;
+        case (BLD_GRAPH_CSR): {
+            return graph_csr_next(&iter->as.graph_csr_iter, (uintmax_t*) value_ptr_ptr);
+        } break;
         case (BLD_DIRECTORY): {
             return directory_next(&iter->as.directory_iter, (bld_string*) value_ptr_ptr);
         } break;
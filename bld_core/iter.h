@@ -5,11 +5,13 @@
 #include "array.h"
 #include "set.h"
 #include "graph.h"
+#include "bitset.h"
 
 enum bld_container_type {
     BLD_ARRAY,
     BLD_SET,
     BLD_GRAPH,
+    BLD_GRAPH_CSR,
     BLD_DIRECTORY
 };
 
@@ -35,6 +37,13 @@ typedef struct bld_iter_graph {
     bld_set visited;
 } bld_iter_graph;
 
+typedef struct bld_iter_graph_csr {
+    enum bld_graph_search_type type;
+    const bld_graph_csr* csr;
+    bld_array stack;
+    bld_bitset visited;
+} bld_iter_graph_csr;
+
 typedef struct bld_iter_directory {
     bld_os_dir* dir;
 } bld_iter_directory;
@@ -43,6 +52,7 @@ union bld_iter_container {
     bld_iter_array array_iter;
     bld_iter_set set_iter;
     bld_iter_graph graph_iter;
+    bld_iter_graph_csr graph_csr_iter;
     bld_iter_directory directory_iter;
 };
 
@@ -55,11 +65,14 @@ bld_iter    iter_array(const bld_array*);
 bld_iter    iter_set(const bld_set*);
 bld_iter    iter_graph(const bld_graph*, uintmax_t);
 bld_iter    iter_graph_children(const bld_graph*, uintmax_t);
+bld_iter    iter_graph_csr(const bld_graph_csr*, bld_node);
 bld_iter    iter_directory(bld_os_dir*);
 int         iter_next(bld_iter*, void**);
 int         array_next(bld_iter_array*, void**);
 int         set_next(bld_iter_set*, void**);
+bld_hash    iter_set_key(const bld_iter*);
 int         graph_next(bld_iter_graph*, uintmax_t*);
+int         graph_csr_next(bld_iter_graph_csr*, uintmax_t*);
 int         directory_next(bld_iter_directory*, bld_string*);
 
 #endif
@@ -1,11 +1,64 @@
+#if defined(__linux__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
 #include <ctype.h>
 #include <string.h>
 #include "logging.h"
 #include "dstr.h"
 #include "json.h"
 
+FILE* json_create(char* path) {
+    FILE* file;
+
+    file = fopen(path, "w");
+    if (file == NULL) {return NULL;}
+
+    setvbuf(file, NULL, _IOFBF, BLD_JSON_BUFFER_SIZE);
+    return file;
+}
+
 void json_serialize_key(FILE* cache, char* key, int depth) {
-    fprintf(cache, "%*c\"%s\": ", 2 * depth, ' ', key);
+    json_serialize_indent(cache, 2 * depth);
+    json_serialize_string(cache, key);
+    fputs(": ", cache);
+}
+
+void json_serialize_indent(FILE* cache, int width) {
+    /* Same output as "%*c" with ' ', i.e. always at least one space */
+    json_putc(' ', cache);
+    while (--width > 0) {json_putc(' ', cache);}
+}
+
+void json_serialize_string(FILE* cache, char* str) {
+    json_putc('\"', cache);
+    while (*str != '\0') {json_putc(*str++, cache);}
+    json_putc('\"', cache);
+}
+
+void json_serialize_uintmax(FILE* cache, uintmax_t num) {
+    char digits[3 * sizeof(uintmax_t) + 1];
+    size_t index;
+
+    index = sizeof(digits);
+    do {
+        digits[--index] = '0' + (char) (num % 10);
+        num /= 10;
+    } while (num > 0);
+
+    while (index < sizeof(digits)) {json_putc(digits[index++], cache);}
+}
+
+int json_key_index(char*, int, char**, int);
+
+FILE* json_open(char* path) {
+    FILE* file;
+
+    file = fopen(path, "r");
+    if (file == NULL) {return NULL;}
+
+    /* Cache and config files are read character by character, a large buffer keeps that off the syscall path */
+    setvbuf(file, NULL, _IOFBF, BLD_JSON_BUFFER_SIZE);
+    return file;
 }
 
 int json_parse_array(FILE* file, void* obj, bld_parse_func parse_func) {
@@ -55,7 +108,7 @@ int json_parse_array(FILE* file, void* obj, bld_parse_func parse_func) {
 }
 
 int json_parse_map(FILE* file, void* obj, int entries, int* parsed, char** keys, bld_parse_func* parse_funcs) {
-    int exists, index, key_num, error, parse_complete;
+    int index, key_num, error, parse_complete;
     bld_string str;
     char c, *temp;
 
@@ -75,6 +128,7 @@ int json_parse_map(FILE* file, void* obj, int entries, int* parsed, char** keys,
     }
 
     key_num = 0;
+    index = -1;
     while (!parse_complete) {
         int i;
 
@@ -90,16 +144,10 @@ int json_parse_map(FILE* file, void* obj, int entries, int* parsed, char** keys,
             goto parse_key_failed;
         }
 
-        exists = 0;
         temp = string_unpack(&str);
-        for (i = 0; i < entries; i++) {
-            if (strcmp(temp, keys[i]) == 0) {
-                exists = 1;
-                index = i;
-            }
-        }
+        index = json_key_index(temp, entries, keys, index + 1);
 
-        if (!exists) {
+        if (index < 0) {
             log_warn("\"%s\" is not a valid key, expected: [", temp);
             for (i = 0; i < entries; i++) {
                 if (i > 0) {printf(",\n");}
@@ -152,21 +200,36 @@ int json_parse_map(FILE* file, void* obj, int entries, int* parsed, char** keys,
     return -1;
 }
 
+int json_key_index(char* key, int entries, char** keys, int expected) {
+    int i;
+
+    /* Maps are serialized in key order so the expected key almost always matches */
+    if (0 <= expected && expected < entries && strcmp(key, keys[expected]) == 0) {
+        return expected;
+    }
+
+    for (i = 0; i < entries; i++) {
+        if (key[0] != keys[i][0]) {continue;}
+        if (strcmp(key, keys[i]) == 0) {return i;}
+    }
+    return -1;
+}
+
 int parse_uintmax(FILE* file, uintmax_t* num_ptr) {
     uintmax_t num;
     int c;
 
     c = next_character(file);
-    if (!isdigit(c)) {
+    if (c < '0' || '9' < c) {
         log_warn("Expected number, got: \'%c\'", c);
         return -1;
     }
 
     num = 0;
-    while (c != EOF && isdigit(c)) {
+    while ('0' <= c && c <= '9') {
         /* Warning: number is assumed to be valid, no overflow etc. */
         num = 10 * num + (c - '0');
-        c = getc(file);
+        c = json_getc(file);
     }
     ungetc(c, file);
 
@@ -177,7 +240,7 @@ int parse_uintmax(FILE* file, uintmax_t* num_ptr) {
 int next_character(FILE* file) {
     int c;
 
-    c = getc(file);
-    while (c != EOF && isspace(c)) {c = getc(file);}
+    c = json_getc(file);
+    while (c == ' ' || c == '\n' || (c != EOF && isspace(c))) {c = json_getc(file);}
     return c;
 }
@@ -3,13 +3,28 @@
 #include <inttypes.h>
 #include "iter.h"
 
+#define BLD_JSON_BUFFER_SIZE (1 << 16)
+
+#if defined(__linux__) && defined(_POSIX_C_SOURCE)
+    #define json_getc(file) getc_unlocked(file)
+    #define json_putc(c, file) putc_unlocked(c, file)
+#else
+    #define json_getc(file) getc(file)
+    #define json_putc(c, file) putc(c, file)
+#endif
+
 typedef void (*bld_serialize_func)(FILE*, void*);
 typedef int (*bld_parse_func)(FILE*, void*);
 
+FILE* json_create(char*);
 void json_serialize_key(FILE*, char*, int);
+void json_serialize_indent(FILE*, int);
+void json_serialize_string(FILE*, char*);
+void json_serialize_uintmax(FILE*, uintmax_t);
 void json_serialize_array(FILE*, bld_iter, bld_serialize_func, int);
 void json_serialize_map(FILE*, void*, int, char**, bld_serialize_func*, int);
 
+FILE* json_open(char*);
 int json_parse_array(FILE*, void*, bld_parse_func);
 int json_parse_map(FILE*, void*, int, int*, char**, bld_parse_func*);
 
@@ -30,7 +30,6 @@ int language_get_includes_c(bld_path* path, bld_file* file, bld_set* files) {
 
     line_number = 0;
     while (1) {
-        FILE* included_file;
         bld_string str;
         bld_path file_path;
         char c;
@@ -51,14 +50,12 @@ int language_get_includes_c(bld_path* path, bld_file* file, bld_set* files) {
         file_path = path_copy(&parent_path);
         path_append_string(&file_path, string_unpack(&str));
 
-        included_file = fopen(path_to_string(&file_path), "r");
-        if (included_file == NULL) {
+        if (!os_file_exists(path_to_string(&file_path))) {
             log_warn("%s:%lu - Included file \"%s\" is not accessible, ignoring.", path_to_string(&file->path), line_number, string_unpack(&str));
             path_free(&file_path);
             string_free(&str);
             goto next_line;
         }
-        fclose(included_file);
 
         {
             int exists;
@@ -95,6 +92,7 @@ int language_get_symbols_c(bld_project_base* base, bld_path* path, bld_file* fil
     FILE* f;
     int c, symbol_type;
     bld_string func;
+    bld_string symbol_name;
     bld_path symbol_path;
     (void)(path);
 
@@ -102,7 +100,12 @@ int language_get_symbols_c(bld_project_base* base, bld_path* path, bld_file* fil
     if (base->cache.loaded) {
         path_append_path(&symbol_path, &base->cache.root);
     }
-    path_append_string(&symbol_path, "symbols.txt");
+
+    /* One symbol file per object, symbols are extracted in parallel */
+    symbol_name = file_object_name(file);
+    string_append_string(&symbol_name, ".symbols");
+    path_append_string(&symbol_path, string_unpack(&symbol_name));
+    string_free(&symbol_name);
 
     {
         int error;
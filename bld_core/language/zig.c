@@ -29,7 +29,6 @@ int language_get_includes_zig(bld_path* path, bld_file* file, bld_set* files) {
 
     line_number = 0;
     while (1) {
-        FILE* included_file;
         bld_string str;
         bld_path file_path;
         char c;
@@ -68,14 +67,12 @@ int language_get_includes_zig(bld_path* path, bld_file* file, bld_set* files) {
         file_path = path_copy(&parent_path);
         path_append_string(&file_path, string_unpack(&str));
 
-        included_file = fopen(path_to_string(&file_path), "r");
-        if (included_file == NULL) {
+        if (!os_file_exists(path_to_string(&file_path))) {
             log_warn("%s:%lu - Included file \"%s\" is not accessible, ignoring.", path_to_string(&file->path), line_number, string_unpack(&str));
             path_free(&file_path);
             string_free(&str);
             goto next_line;
         }
-        fclose(included_file);
 
         {
             int exists;
@@ -3,6 +3,7 @@
 #include "linker.h"
 #include "logging.h"
 #include "json.h"
+#include "hash.h"
 
 bld_linker linker_new(bld_linker_type type, char* executable) {
     bld_linker linker;
@@ -31,6 +32,17 @@ bld_linker linker_copy(bld_linker* linker) {
     return cpy;
 }
 
+uintmax_t linker_hash(bld_linker* linker) {
+    uintmax_t seed;
+
+    seed = 6151;
+    seed = hash_combine(seed, linker->type);
+    seed = hash_combine(seed, string_hash(string_unpack(&linker->executable)));
+    seed = hash_combine(seed, linker_flags_hash(&linker->flags));
+
+    return seed;
+}
+
 void linker_add_flag(bld_linker* linker, char* flag) {
     linker_flags_add_flag(&linker->flags, flag);
 }
@@ -85,7 +97,7 @@ uintmax_t linker_flags_hash(bld_linker_flags* linker_flags) {
     seed = 335545;
     iter = iter_array(&linker_flags->flags);
     while (iter_next(&iter, (void**) &flag)) {
-        seed = (seed << 7) + string_hash(string_unpack(flag));
+        seed = hash_combine(seed, string_hash(string_unpack(flag)));
     }
 
     return seed;
@@ -119,23 +131,24 @@ void linker_flags_append(bld_string* str, bld_linker_flags* flags) {
 }
 
 void serialize_linker(FILE* cache, bld_linker* linker, int depth) {
-    fprintf(cache, "{\n");
+    fputs("{\n", cache);
 
     json_serialize_key(cache, "type", depth);
-    fprintf(cache, "\"%s\"", string_unpack(linker_get_string(linker->type)));
+    json_serialize_string(cache, string_unpack(linker_get_string(linker->type)));
 
-    fprintf(cache, ",\n");
+    fputs(",\n", cache);
     json_serialize_key(cache, "executable", depth);
-    fprintf(cache, "\"%s\"", string_unpack(&linker->executable));
+    json_serialize_string(cache, string_unpack(&linker->executable));
 
     if (linker->flags.flags.size > 0) {
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "flags", depth);
         serialize_linker_flags(cache, &linker->flags, depth + 1);
     }
 
-    fprintf(cache, "\n");
-    fprintf(cache, "%*c}", 2 * (depth - 1), ' ');
+    fputc('\n', cache);
+    json_serialize_indent(cache, 2 * (depth - 1));
+    fputc('}', cache);
 }
 
 void serialize_linker_flags(FILE* cache, bld_linker_flags* flags, int depth) {
@@ -143,26 +156,27 @@ void serialize_linker_flags(FILE* cache, bld_linker_flags* flags, int depth) {
     int first;
     bld_iter iter;
 
-    fprintf(cache, "[");
+    fputc('[', cache);
     if (flags->flags.size > 1) {
-        fprintf(cache, "\n");
+        fputc('\n', cache);
     }
 
     first = 1;
     iter = iter_array(&flags->flags);
     while (iter_next(&iter, (void**) &flag)) {
-        if (!first) {fprintf(cache, ",\n");}
+        if (!first) {fputs(",\n", cache);}
         else {first = 0;}
         if (flags->flags.size > 1) {
-            fprintf(cache, "%*c", 2 * depth, ' ');
+            json_serialize_indent(cache, 2 * depth);
         }
-        fprintf(cache, "\"%s\"", string_unpack(flag));
+        json_serialize_string(cache, string_unpack(flag));
     }
 
     if (flags->flags.size > 1) {
-        fprintf(cache, "\n%*c", 2 * (depth - 1), ' ');
+        fputc('\n', cache);
+        json_serialize_indent(cache, 2 * (depth - 1));
     }
-    fprintf(cache, "]");
+    fputc(']', cache);
 }
 
 int parse_linker(FILE* file, bld_linker* linker) {
@@ -1,8 +1,11 @@
 #include "../logging.h"
+#include "../os.h"
 #include "linker.h"
 #include "gcc.h"
 #include "clang.h"
 #include "zig.h"
+#include "mold.h"
+#include "lld.h"
 
 bld_array linker_get_available(void) {
     bld_array linkers = array_new(sizeof(bld_string));
@@ -10,6 +13,12 @@ bld_array linker_get_available(void) {
     array_push(&linkers, &bld_linker_string_gcc);
     array_push(&linkers, &bld_linker_string_clang);
     array_push(&linkers, &bld_linker_string_zig);
+    if (linker_installed(BLD_LINKER_MOLD)) {
+        array_push(&linkers, &bld_linker_string_mold);
+    }
+    if (linker_installed(BLD_LINKER_LLD)) {
+        array_push(&linkers, &bld_linker_string_lld);
+    }
 
     return linkers;
 }
@@ -19,12 +28,16 @@ bld_linker_type linker_get_mapping(bld_string* name) {
     bld_string* linkers[] = {
         &bld_linker_string_gcc,
         &bld_linker_string_clang,
-        &bld_linker_string_zig
+        &bld_linker_string_zig,
+        &bld_linker_string_mold,
+        &bld_linker_string_lld
     };
     bld_linker_type types[] = {
         BLD_LINKER_GCC,
         BLD_LINKER_CLANG,
-        BLD_LINKER_ZIG
+        BLD_LINKER_ZIG,
+        BLD_LINKER_MOLD,
+        BLD_LINKER_LLD
     };
 
     if (sizeof(linkers) / sizeof(*linkers) != sizeof(types) / sizeof(*types)) {
@@ -44,7 +57,9 @@ bld_string* linker_get_string(bld_linker_type type) {
     bld_string* linkers[] = {
         &bld_linker_string_gcc,
         &bld_linker_string_clang,
-        &bld_linker_string_zig
+        &bld_linker_string_zig,
+        &bld_linker_string_mold,
+        &bld_linker_string_lld
     };
 
     if (sizeof(linkers) / sizeof(*linkers) != BLD_LINKER_AMOUNT) {
@@ -58,6 +73,21 @@ bld_string* linker_get_string(bld_linker_type type) {
     return linkers[type];
 }
 
+int linker_installed(bld_linker_type type) {
+    switch (type) {
+        case (BLD_LINKER_MOLD):
+            return os_program_exists("ld.mold");
+        case (BLD_LINKER_LLD):
+            return os_program_exists("ld.lld");
+        default:
+            return 1;
+    }
+}
+
+int linker_is_variant(bld_linker_type type) {
+    return type == BLD_LINKER_MOLD || type == BLD_LINKER_LLD;
+}
+
 int linker_executable_make(bld_linker_type type, bld_string* linker, bld_path* root, bld_array* files, bld_array* flags, bld_path* path) {
     switch (type) {
         case (BLD_LINKER_GCC):
@@ -66,6 +96,10 @@ int linker_executable_make(bld_linker_type type, bld_string* linker, bld_path* r
             return linker_executable_make_clang(linker, root, files, flags, path);
         case (BLD_LINKER_ZIG):
             return linker_executable_make_zig(linker, root, files, flags, path);
+        case (BLD_LINKER_MOLD):
+            return linker_executable_make_mold(linker, root, files, flags, path);
+        case (BLD_LINKER_LLD):
+            return linker_executable_make_lld(linker, root, files, flags, path);
         case (BLD_LINKER_AMOUNT):
             log_fatal(LOG_FATAL_PREFIX "invalid type");
     }
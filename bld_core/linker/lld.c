@@ -0,0 +1,22 @@
+#include "../logging.h"
+#include "lld.h"
+#include "gcc.h"
+
+bld_string bld_linker_string_lld = STRING_COMPILE_TIME_PACK("lld");
+
+int linker_executable_make_lld(bld_string* linker, bld_path* root, bld_array* files, bld_array* flags, bld_path* name) {
+    int error;
+    bld_string driver;
+
+    driver = string_copy(linker);
+    if (linker_installed(BLD_LINKER_LLD)) {
+        string_append_string(&driver, " -fuse-ld=lld");
+    } else {
+        log_warn("lld is not installed, linking with the default linker of \"%s\"", string_unpack(linker));
+    }
+
+    error = linker_executable_make_gcc(&driver, root, files, flags, name);
+
+    string_free(&driver);
+    return error;
+}
@@ -0,0 +1,5 @@
+#include "linker.h"
+
+extern bld_string bld_linker_string_lld;
+
+int linker_executable_make_lld(bld_string*, bld_path*, bld_array*, bld_array*, bld_path*);
@@ -0,0 +1,23 @@
+#include "../logging.h"
+#include "mold.h"
+#include "gcc.h"
+
+bld_string bld_linker_string_mold = STRING_COMPILE_TIME_PACK("mold");
+
+int linker_executable_make_mold(bld_string* linker, bld_path* root, bld_array* files, bld_array* flags, bld_path* name) {
+    int error;
+    bld_string driver;
+
+    /* The executable is the compiler driver, mold only replaces the ld it invokes */
+    driver = string_copy(linker);
+    if (linker_installed(BLD_LINKER_MOLD)) {
+        string_append_string(&driver, " -fuse-ld=mold");
+    } else {
+        log_warn("mold is not installed, linking with the default linker of \"%s\"", string_unpack(linker));
+    }
+
+    error = linker_executable_make_gcc(&driver, root, files, flags, name);
+
+    string_free(&driver);
+    return error;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <string.h>
+#include "os.h"
+#include "logging.h"
+#include "mem.h"
+
+void mem_count_allocation(size_t);
+void mem_count_free(size_t);
+
+bld_mem mem_state = {0, BLD_MEM_OTHER, 0, 0, {{0, 0, 0, 0}}, NULL};
+
+char* bld_mem_phase_names[BLD_MEM_PHASES] = {
+    "other",
+    "index",
+    "cache load",
+    "graph",
+    "compile",
+    "save"
+};
+
+void mem_start(void) {
+    if (mem_state.enabled) {
+        log_warn("Memory accounting already started");
+        return;
+    }
+
+    memset(mem_state.phases, 0, sizeof(mem_state.phases));
+    mem_state.live = 0;
+    mem_state.peak = 0;
+    mem_state.lock = os_mutex_new();
+    mem_state.enabled = 1;
+}
+
+void mem_stop(void) {
+    int i;
+    bld_mem_stats* stats;
+
+    if (!mem_state.enabled) {return;}
+    mem_state.enabled = 0;
+    os_mutex_free(mem_state.lock);
+    mem_state.lock = NULL;
+
+    printf("Memory by phase, peak %" PRIuMAX " bytes live\n", mem_state.peak);
+    printf("  %-10s %12s %12s %14s %14s\n", "phase", "allocations", "frees", "bytes", "peak bytes");
+    for (i = 0; i < BLD_MEM_PHASES; i++) {
+        stats = &mem_state.phases[i];
+        if (stats->allocations == 0 && stats->frees == 0) {continue;}
+        printf(
+            "  %-10s %12" PRIuMAX " %12" PRIuMAX " %14" PRIuMAX " %14" PRIuMAX "\n",
+            bld_mem_phase_names[i],
+            stats->allocations,
+            stats->frees,
+            stats->bytes,
+            stats->peak
+        );
+    }
+}
+
+bld_mem_phase mem_phase(bld_mem_phase phase) {
+    bld_mem_phase previous;
+
+    if (!mem_state.enabled) {
+        previous = mem_state.phase;
+        mem_state.phase = phase;
+        return previous;
+    }
+
+    os_mutex_lock(mem_state.lock);
+    previous = mem_state.phase;
+    mem_state.phase = phase;
+    if (mem_state.live > mem_state.phases[phase].peak) {
+        mem_state.phases[phase].peak = mem_state.live;
+    }
+    os_mutex_unlock(mem_state.lock);
+    return previous;
+}
+
+void* mem_counted_malloc(size_t size) {
+    void* ptr;
+
+    ptr = malloc(size);
+    if (ptr != NULL) {mem_count_allocation(os_allocation_size(ptr));}
+    return ptr;
+}
+
+void* mem_counted_calloc(size_t amount, size_t size) {
+    void* ptr;
+
+    ptr = calloc(amount, size);
+    if (ptr != NULL) {mem_count_allocation(os_allocation_size(ptr));}
+    return ptr;
+}
+
+void* mem_counted_realloc(void* ptr, size_t size) {
+    size_t previous;
+    void* moved;
+
+    previous = ptr == NULL ? 0 : os_allocation_size(ptr);
+    moved = realloc(ptr, size);
+    if (moved == NULL) {return NULL;}
+
+    if (ptr != NULL) {mem_count_free(previous);}
+    mem_count_allocation(os_allocation_size(moved));
+    return moved;
+}
+
+void mem_counted_free(void* ptr) {
+    if (ptr == NULL) {return;}
+    mem_count_free(os_allocation_size(ptr));
+    free(ptr);
+}
+
+void mem_count_allocation(size_t size) {
+    bld_mem_stats* stats;
+
+    /* Containers are filled from worker threads during compilation and graph extraction */
+    os_mutex_lock(mem_state.lock);
+    stats = &mem_state.phases[mem_state.phase];
+    stats->allocations += 1;
+    stats->bytes += size;
+
+    mem_state.live += size;
+    if (mem_state.live > mem_state.peak) {mem_state.peak = mem_state.live;}
+    if (mem_state.live > stats->peak) {stats->peak = mem_state.live;}
+    os_mutex_unlock(mem_state.lock);
+}
+
+void mem_count_free(size_t size) {
+    os_mutex_lock(mem_state.lock);
+    mem_state.phases[mem_state.phase].frees += 1;
+
+    /* Memory allocated before accounting started is released without having been counted */
+    mem_state.live = size > mem_state.live ? 0 : mem_state.live - size;
+    os_mutex_unlock(mem_state.lock);
+}
@@ -0,0 +1,50 @@
+#ifndef MEM_H
+#define MEM_H
+#include <stdlib.h>
+#include <inttypes.h>
+#include "os.h"
+
+typedef enum bld_mem_phase {
+    BLD_MEM_OTHER,
+    BLD_MEM_INDEX,
+    BLD_MEM_CACHE_LOAD,
+    BLD_MEM_GRAPH,
+    BLD_MEM_COMPILE,
+    BLD_MEM_SAVE,
+    BLD_MEM_PHASES
+} bld_mem_phase;
+
+typedef struct bld_mem_stats {
+    uintmax_t allocations;
+    uintmax_t frees;
+    uintmax_t bytes;
+    uintmax_t peak;
+} bld_mem_stats;
+
+typedef struct bld_mem {
+    int enabled;
+    bld_mem_phase phase;
+    uintmax_t live;
+    uintmax_t peak;
+    bld_mem_stats phases[BLD_MEM_PHASES];
+    bld_os_mutex* lock;
+} bld_mem;
+
+extern bld_mem mem_state;
+
+/* The containers allocate through these, while accounting is off they cost one branch */
+#define mem_malloc(size) (mem_state.enabled ? mem_counted_malloc(size) : malloc(size))
+#define mem_calloc(amount, size) (mem_state.enabled ? mem_counted_calloc(amount, size) : calloc(amount, size))
+#define mem_realloc(ptr, size) (mem_state.enabled ? mem_counted_realloc(ptr, size) : realloc(ptr, size))
+#define mem_free(ptr) (mem_state.enabled ? mem_counted_free(ptr) : free(ptr))
+
+void            mem_start(void);
+void            mem_stop(void);
+bld_mem_phase   mem_phase(bld_mem_phase);
+
+void*           mem_counted_malloc(size_t);
+void*           mem_counted_calloc(size_t, size_t);
+void*           mem_counted_realloc(void*, size_t);
+void            mem_counted_free(void*);
+
+#endif
@@ -1,22 +1,131 @@
+#if defined(__linux__)
+    #define _POSIX_C_SOURCE 200809L
+#endif
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include "logging.h"
 #include "os.h"
 
+int os_stat_path(char*, bld_os_stat*);
+
+bld_os_stat_cache os_stat_state = {0};
+
+void os_stat_cache_start(void) {
+    if (os_stat_state.enabled) {return;}
+
+    os_stat_state.enabled = 1;
+    os_stat_state.entries = set_new(sizeof(bld_os_stat));
+    os_stat_state.lookups = 0;
+    os_stat_state.syscalls = 0;
+    os_stat_state.lock = os_mutex_new();
+}
+
+void os_stat_cache_stop(void) {
+    if (!os_stat_state.enabled) {return;}
+
+    log_debug("Stat cache: %" PRIuMAX " lookups, %" PRIuMAX " stat calls, %" PRIuMAX " saved", os_stat_state.lookups, os_stat_state.syscalls, os_stat_state.lookups - os_stat_state.syscalls);
+
+    set_free(&os_stat_state.entries);
+    os_mutex_free(os_stat_state.lock);
+    os_stat_state.enabled = 0;
+}
+
+int os_stat(char* path, bld_os_stat* info) {
+    bld_hash hash;
+    bld_os_stat* cached;
+
+    if (!os_stat_state.enabled) {
+        return os_stat_path(path, info);
+    }
+
+    hash = string_hash(path);
+    os_mutex_lock(os_stat_state.lock);
+    os_stat_state.lookups += 1;
+    cached = set_get(&os_stat_state.entries, hash);
+    if (cached != NULL) {
+        *info = *cached;
+        os_mutex_unlock(os_stat_state.lock);
+        return info->type == BLD_OS_STAT_MISSING ? -1 : 0;
+    }
+    os_stat_state.syscalls += 1;
+    os_mutex_unlock(os_stat_state.lock);
+
+    os_stat_path(path, info);
+
+    /* Another thread may have stated the same path in the meantime, its entry is kept */
+    os_mutex_lock(os_stat_state.lock);
+    if (!set_has(&os_stat_state.entries, hash)) {
+        set_add(&os_stat_state.entries, hash, info);
+    }
+    os_mutex_unlock(os_stat_state.lock);
+
+    return info->type == BLD_OS_STAT_MISSING ? -1 : 0;
+}
+
+void os_stat_remember(char* path, bld_os_stat* info) {
+    bld_hash hash;
+
+    if (!os_stat_state.enabled) {return;}
+
+    /* A later index of the same tree, e.g. the next target of a build, overwrites the entry */
+    hash = string_hash(path);
+    os_mutex_lock(os_stat_state.lock);
+    set_remove(&os_stat_state.entries, hash);
+    set_add(&os_stat_state.entries, hash, info);
+    os_mutex_unlock(os_stat_state.lock);
+}
+
+void os_stat_forget(char* path) {
+    if (!os_stat_state.enabled) {return;}
+
+    os_mutex_lock(os_stat_state.lock);
+    set_remove(&os_stat_state.entries, string_hash(path));
+    os_mutex_unlock(os_stat_state.lock);
+}
+
 int os_file_exists(char* path) {
-    FILE* file;
+    bld_os_stat info;
+    return os_stat(path, &info) == 0;
+}
 
-    file = fopen(path, "r");
-    if (file != NULL) {
-        fclose(file);
+int os_dir_exists(char* path) {
+    bld_os_stat info;
+
+    os_stat(path, &info);
+    return info.type == BLD_OS_STAT_DIRECTORY;
+}
+
+uintmax_t os_info_id(char* path) {
+    bld_os_stat info;
+
+    if (os_stat(path, &info) < 0) {
+        return BLD_INVALID_IDENITIFIER;
     }
+    return info.id;
+}
+
+uintmax_t os_info_mtime(char* path) {
+    bld_os_stat info;
 
-    return file != NULL;
+    if (os_stat(path, &info) < 0) {
+        return 0;
+    }
+    return info.mtime;
 }
 
 #if defined(__linux__)
     #include <unistd.h>
+    #include <fcntl.h>
     #include <dirent.h>
     #include <sys/stat.h>
+    #include <sys/wait.h>
+    #include <time.h>
+    #include <pthread.h>
+    #include <malloc.h>
+
+    void os_stat_fill(struct stat*, bld_os_stat*);
 
     int os_cwd(char* buffer, int length) {
         if (length <= 0) {log_fatal("os_cwd: negative buffer length");}
@@ -27,25 +136,66 @@ int os_file_exists(char* path) {
         return chdir(path);
     }
 
-    int os_dir_exists(char* path) {
-        bld_os_dir* dir;
 
-        dir = os_dir_open(path);
-        if (dir != NULL) {
-            os_dir_close(dir);
-        }
+    int os_dir_make(char* path) {
+        int result, error;
+
+        result = mkdir(path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+        error = errno;
+        os_stat_forget(path);
+        errno = error;
 
-        return dir != NULL;
+        return result;
     }
 
-    int os_dir_make(char* path) {
-        return mkdir(path, S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH);
+    int os_dir_remove(char* path) {
+        int result;
+        size_t length;
+        DIR* dir;
+        struct dirent* entry;
+        struct stat file;
+        char sub_path[FILENAME_MAX];
+
+        dir = opendir(path);
+        if (dir == NULL) {return -1;}
+
+        result = 0;
+        length = strlen(path);
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {continue;}
+            if (length + strlen(entry->d_name) + 2 > FILENAME_MAX) {result = -1; continue;}
+
+            sprintf(sub_path, "%s/%s", path, entry->d_name);
+            if (lstat(sub_path, &file) == 0 && S_ISDIR(file.st_mode)) {
+                result = os_dir_remove(sub_path) || result;
+            } else if (unlink(sub_path) < 0) {
+                result = -1;
+            }
+            os_stat_forget(sub_path);
+        }
+        closedir(dir);
+
+        if (rmdir(path) < 0) {result = -1;}
+        os_stat_forget(path);
+        return result;
     }
 
     bld_os_dir* os_dir_open(char* path) {
         return (bld_os_dir*) opendir(path);
     }
 
+    bld_os_dir* os_dir_open_at(bld_os_dir* parent, char* name) {
+        int fd;
+        DIR* dir;
+
+        fd = openat(dirfd((DIR*) parent), name, O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {return NULL;}
+
+        dir = fdopendir(fd);
+        if (dir == NULL) {close(fd);}
+        return (bld_os_dir*) dir;
+    }
+
     int os_dir_close(bld_os_dir* dir) {
         return closedir((DIR*) dir);
     }
@@ -62,20 +212,191 @@ int os_file_exists(char* path) {
         return ((struct dirent*) file)->d_ino;
     }
 
-    uintmax_t os_info_id(char* path) {
+    int os_stat_path(char* path, bld_os_stat* info) {
         struct stat file;
+
         if (stat(path, &file) < 0) {
-            return BLD_INVALID_IDENITIFIER;
+            os_stat_fill(NULL, info);
+            return -1;
         }
-        return file.st_ino;
+
+        os_stat_fill(&file, info);
+        return 0;
     }
 
-    uintmax_t os_info_mtime(char* path) {
+    int os_stat_at(bld_os_dir* dir, char* name, bld_os_stat* info) {
         struct stat file;
-        if (stat(path, &file) < 0) {
+
+        if (fstatat(dirfd((DIR*) dir), name, &file, 0) < 0) {
+            os_stat_fill(NULL, info);
+            return -1;
+        }
+
+        os_stat_fill(&file, info);
+        return 0;
+    }
+
+    void os_stat_fill(struct stat* file, bld_os_stat* info) {
+        if (file == NULL) {
+            info->type = BLD_OS_STAT_MISSING;
+            info->id = BLD_INVALID_IDENITIFIER;
+            info->mtime = 0;
+            info->mtime_ns = 0;
+            info->size = 0;
+            return;
+        }
+
+        if (S_ISREG(file->st_mode)) {
+            info->type = BLD_OS_STAT_FILE;
+        } else if (S_ISDIR(file->st_mode)) {
+            info->type = BLD_OS_STAT_DIRECTORY;
+        } else {
+            info->type = BLD_OS_STAT_OTHER;
+        }
+        info->id = file->st_ino;
+        info->mtime = file->st_mtime;
+        info->mtime_ns = (uintmax_t) file->st_mtim.tv_sec * 1000000000 + (uintmax_t) file->st_mtim.tv_nsec;
+        info->size = file->st_size;
+    }
+
+    uintmax_t os_time_monotonic(void) {
+        struct timespec time;
+        if (clock_gettime(CLOCK_MONOTONIC, &time) < 0) {
             return 0;
         }
-        return file.st_mtime;
+        return (uintmax_t) time.tv_sec * 1000000000 + (uintmax_t) time.tv_nsec;
+    }
+
+    int os_cpu_count(void) {
+        long count;
+
+        count = sysconf(_SC_NPROCESSORS_ONLN);
+        if (count < 1) {
+            return 1;
+        }
+        return (int) count;
+    }
+
+    size_t os_allocation_size(void* ptr) {
+        return malloc_usable_size(ptr);
+    }
+
+    int os_program_exists(char* name) {
+        size_t length;
+        char* paths;
+        char* end;
+        char path[FILENAME_MAX];
+
+        paths = getenv("PATH");
+        if (paths == NULL) {return 0;}
+
+        while (*paths != '\0') {
+            end = strchr(paths, ':');
+            if (end == NULL) {end = paths + strlen(paths);}
+
+            length = end - paths;
+            if (length > 0 && length + strlen(name) + 2 <= FILENAME_MAX) {
+                memcpy(path, paths, length);
+                path[length] = '/';
+                strcpy(path + length + 1, name);
+                if (access(path, X_OK) == 0) {return 1;}
+            }
+
+            paths = *end == ':' ? end + 1 : end;
+        }
+        return 0;
+    }
+
+    int os_process_start(char* command, bld_os_process* process) {
+        pid_t pid;
+
+        fflush(stdout);
+        pid = fork();
+        if (pid < 0) {
+            return -1;
+        } else if (pid == 0) {
+            execl("/bin/sh", "sh", "-c", command, (char*) NULL);
+            _exit(127);
+        }
+
+        *process = (bld_os_process) pid;
+        return 0;
+    }
+
+    int os_process_wait(bld_os_process* process, int* status) {
+        pid_t pid;
+        int code;
+
+        do {
+            pid = waitpid(-1, &code, 0);
+        } while (pid < 0 && errno == EINTR);
+
+        if (pid < 0) {
+            return -1;
+        }
+
+        *process = (bld_os_process) pid;
+        *status = code;
+        return 0;
+    }
+
+    int os_process_replace(char* path, char** argv) {
+        fflush(stdout);
+        fflush(stderr);
+        execv(path, argv);
+        return -1;
+    }
+
+    bld_os_thread* os_thread_start(bld_os_thread_func* func, void* arg) {
+        pthread_t* thread;
+
+        thread = malloc(sizeof(pthread_t));
+        if (thread == NULL) {log_fatal("os_thread_start: could not allocate thread");}
+
+        if (pthread_create(thread, NULL, func, arg)) {
+            free(thread);
+            return NULL;
+        }
+
+        return (bld_os_thread*) thread;
+    }
+
+    int os_thread_join(bld_os_thread* thread) {
+        int error;
+
+        error = pthread_join(*(pthread_t*) thread, NULL);
+        free(thread);
+        return error;
+    }
+
+    bld_os_mutex* os_mutex_new(void) {
+        pthread_mutex_t* mutex;
+
+        mutex = malloc(sizeof(pthread_mutex_t));
+        if (mutex == NULL) {log_fatal("os_mutex_new: could not allocate mutex");}
+
+        if (pthread_mutex_init(mutex, NULL)) {
+            log_fatal("os_mutex_new: could not initialize mutex");
+        }
+
+        return (bld_os_mutex*) mutex;
+    }
+
+    void os_mutex_free(bld_os_mutex* mutex) {
+        pthread_mutex_destroy((pthread_mutex_t*) mutex);
+        free(mutex);
+    }
+
+    void os_mutex_lock(bld_os_mutex* mutex) {
+        if (pthread_mutex_lock((pthread_mutex_t*) mutex)) {
+            log_fatal("os_mutex_lock: could not lock mutex");
+        }
+    }
+
+    void os_mutex_unlock(bld_os_mutex* mutex) {
+        if (pthread_mutex_unlock((pthread_mutex_t*) mutex)) {
+            log_fatal("os_mutex_unlock: could not unlock mutex");
+        }
     }
 #elif defined(_WIN32)
     #error "No support for windows yet"
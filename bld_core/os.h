@@ -1,21 +1,60 @@
 #ifndef OS_H
 #define OS_H
 #include <inttypes.h>
+#include "set.h"
 
 #define BLD_INVALID_IDENITIFIER (0)
 
 typedef void bld_os_dir;
 typedef void bld_os_file;
+typedef uintmax_t bld_os_process;
+typedef void bld_os_thread;
+typedef void bld_os_mutex;
+typedef void* (bld_os_thread_func)(void*);
+
+typedef enum bld_os_stat_type {
+    BLD_OS_STAT_MISSING,
+    BLD_OS_STAT_FILE,
+    BLD_OS_STAT_DIRECTORY,
+    BLD_OS_STAT_OTHER
+} bld_os_stat_type;
+
+typedef struct bld_os_stat {
+    bld_os_stat_type type;
+    uintmax_t id;
+    uintmax_t mtime;
+    uintmax_t mtime_ns;
+    uintmax_t size;
+} bld_os_stat;
+
+typedef struct bld_os_stat_cache {
+    int enabled;
+    bld_set entries;
+    uintmax_t lookups;
+    uintmax_t syscalls;
+    bld_os_mutex* lock;
+} bld_os_stat_cache;
+
+extern bld_os_stat_cache os_stat_state;
 
 int             os_cwd(char*, int);
 int             os_set_cwd(char*);
 
 int             os_dir_exists(char*);
 int             os_dir_make(char*);
+int             os_dir_remove(char*);
 bld_os_dir*     os_dir_open(char*);
+bld_os_dir*     os_dir_open_at(bld_os_dir*, char*);
 int             os_dir_close(bld_os_dir*);
 bld_os_file*    os_dir_read(bld_os_dir*);
 
+int             os_stat(char*, bld_os_stat*);
+int             os_stat_at(bld_os_dir*, char*, bld_os_stat*);
+void            os_stat_remember(char*, bld_os_stat*);
+void            os_stat_forget(char*);
+void            os_stat_cache_start(void);
+void            os_stat_cache_stop(void);
+
 int             os_file_exists(char*);
 char*           os_file_name(bld_os_file*);
 uintmax_t       os_file_id(bld_os_file*);
@@ -23,6 +62,23 @@ uintmax_t       os_file_id(bld_os_file*);
 uintmax_t       os_info_id(char*);
 uintmax_t       os_info_mtime(char*);
 
+uintmax_t       os_time_monotonic(void);
+size_t          os_allocation_size(void*);
+int             os_cpu_count(void);
+int             os_program_exists(char*);
+
+int             os_process_start(char*, bld_os_process*);
+int             os_process_wait(bld_os_process*, int*);
+int             os_process_replace(char*, char**);
+
+bld_os_thread*  os_thread_start(bld_os_thread_func*, void*);
+int             os_thread_join(bld_os_thread*);
+
+bld_os_mutex*   os_mutex_new(void);
+void            os_mutex_free(bld_os_mutex*);
+void            os_mutex_lock(bld_os_mutex*);
+void            os_mutex_unlock(bld_os_mutex*);
+
 #if defined(__linux__)
     #define BLD_EXECUTABLE_FILE_ENDING "out"
 #elif defined(_WIN32)
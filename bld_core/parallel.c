@@ -0,0 +1,95 @@
+#include <stdlib.h>
+#include "os.h"
+#include "logging.h"
+#include "parallel.h"
+
+typedef struct bld_parallel {
+    size_t next;
+    size_t count;
+    bld_os_mutex* lock;
+    bld_parallel_func* func;
+    void* context;
+} bld_parallel;
+
+typedef struct bld_parallel_worker {
+    bld_parallel* parallel;
+    int id;
+} bld_parallel_worker;
+
+void* parallel_worker(void*);
+
+void parallel_for(size_t count, int workers, bld_parallel_func* func, void* context) {
+    int i;
+    bld_parallel parallel;
+    bld_parallel_worker* args;
+    bld_os_thread** threads;
+
+    if (workers < 1) {workers = 1;}
+    if ((size_t) workers > count) {workers = (int) count;}
+
+    if (workers <= 1) {
+        size_t index;
+
+        for (index = 0; index < count; index++) {
+            func(context, index, 0);
+        }
+        return;
+    }
+
+    parallel.next = 0;
+    parallel.count = count;
+    parallel.lock = os_mutex_new();
+    parallel.func = func;
+    parallel.context = context;
+
+    args = malloc(workers * sizeof(bld_parallel_worker));
+    threads = malloc(workers * sizeof(bld_os_thread*));
+    if (args == NULL || threads == NULL) {log_fatal(LOG_FATAL_PREFIX "could not allocate workers");}
+
+    /* The calling thread works as worker 0 */
+    for (i = 0; i < workers; i++) {
+        args[i].parallel = &parallel;
+        args[i].id = i;
+        threads[i] = NULL;
+        if (i > 0) {
+            threads[i] = os_thread_start(parallel_worker, &args[i]);
+        }
+    }
+
+    parallel_worker(&args[0]);
+
+    for (i = 1; i < workers; i++) {
+        if (threads[i] == NULL) {continue;}
+        if (os_thread_join(threads[i])) {
+            log_fatal(LOG_FATAL_PREFIX "could not join worker %d", i);
+        }
+    }
+
+    free(threads);
+    free(args);
+    os_mutex_free(parallel.lock);
+}
+
+void* parallel_worker(void* arg) {
+    size_t index;
+    bld_parallel_worker* worker;
+    bld_parallel* parallel;
+
+    worker = arg;
+    parallel = worker->parallel;
+
+    while (1) {
+        os_mutex_lock(parallel->lock);
+        if (parallel->next >= parallel->count) {
+            os_mutex_unlock(parallel->lock);
+            break;
+        }
+        index = parallel->next;
+        parallel->next += 1;
+        os_mutex_unlock(parallel->lock);
+
+        parallel->func(parallel->context, index, worker->id);
+    }
+
+    return NULL;
+}
@@ -0,0 +1,9 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <stddef.h>
+
+typedef void (bld_parallel_func)(void*, size_t, int);
+
+void parallel_for(size_t, int, bld_parallel_func*, void*);
+
+#endif
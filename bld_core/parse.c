@@ -4,6 +4,8 @@
 #include <string.h>
 #include "os.h"
 #include "logging.h"
+#include "trace.h"
+#include "mem.h"
 #include "path.h"
 #include "project.h"
 #include "json.h"
@@ -14,8 +16,18 @@ typedef struct bld_parsing_file {
     uintmax_t parent;
     bld_path* parent_path;
     int is_rebuild_main;
+    int is_journal;
 } bld_parsing_file;
 
+typedef struct bld_parsing_journal {
+    bld_project_cache* cache;
+    bld_project_cache entries;
+    bld_array removed;
+    int has_build;
+    int has_link;
+    int inconsistent;
+} bld_parsing_journal;
+
 typedef enum bld_file_fields {
     BLD_PARSE_TYPE = 0,
     BLD_PARSE_MTIME = 1,
@@ -27,14 +39,26 @@ typedef enum bld_file_fields {
     BLD_PARSE_INCLUDES = 7,
     BLD_PARSE_DEFINED = 8,
     BLD_PARSE_UNDEFINED = 9,
-    BLD_PARSE_FILES = 10,
-    BLD_TOTAL_FIELDS = 11
+    BLD_PARSE_COMPILE_TIMES = 10,
+    BLD_PARSE_FILES = 11,
+    BLD_TOTAL_FIELDS = 12
 } bld_file_fields;
 
 void ensure_directory_exists(bld_path*);
 int parse_cache(bld_project_cache*, bld_path*);
 int parse_project_linker(FILE*, bld_project_cache*);
 int parse_project_rebuild_main(FILE*, bld_project_cache*);
+int parse_project_builds(FILE*, bld_project_cache*);
+int parse_project_build(FILE*, bld_array*);
+int parse_build_wall_time(FILE*, bld_build_stats*);
+int parse_build_cpu_time(FILE*, bld_build_stats*);
+int parse_build_link_time(FILE*, bld_build_stats*);
+int parse_build_longest_compile(FILE*, bld_build_stats*);
+int parse_build_compiled(FILE*, bld_build_stats*);
+int parse_build_cached(FILE*, bld_build_stats*);
+int parse_project_link(FILE*, bld_project_cache*);
+int parse_link_fingerprint(FILE*, bld_project_cache*);
+int parse_link_mtime(FILE*, bld_project_cache*);
 
 int parse_project_files(FILE*, bld_project_cache*);
 int parse_file(FILE*, bld_parsing_file*);
@@ -50,9 +74,24 @@ int parse_file_undefined_symbols(FILE*, bld_parsing_file*);
 int parse_file_function(FILE*, bld_set*);
 int parse_file_includes(FILE*, bld_parsing_file*);
 int parse_file_include(FILE*, bld_array*);
+int parse_file_compile_times(FILE*, bld_parsing_file*);
+int parse_file_compile_time(FILE*, bld_array*);
 int parse_file_sub_files(FILE*, bld_parsing_file*);
 int parse_file_sub_file(FILE*, bld_parsing_file*);
 
+int parse_journal(bld_project_cache*, bld_path*);
+int parse_journal_record(FILE*, bld_parsing_journal*);
+int parse_journal_files(FILE*, bld_parsing_journal*);
+int parse_journal_file(FILE*, bld_parsing_journal*);
+int parse_journal_removed(FILE*, bld_parsing_journal*);
+int parse_journal_build(FILE*, bld_parsing_journal*);
+int parse_journal_link(FILE*, bld_parsing_journal*);
+void parse_journal_apply(bld_parsing_journal*);
+void parse_journal_apply_file(bld_parsing_journal*, bld_file*);
+void parse_journal_apply_removed(bld_parsing_journal*, bld_path*);
+void parse_journal_detach(bld_set*, bld_file*);
+void parse_journal_free(bld_parsing_journal*);
+
 void ensure_directory_exists(bld_path* directory_path) {
     errno = 0;
     os_dir_make(path_to_string(directory_path));
@@ -90,16 +129,34 @@ void project_load_cache(bld_forward_project* fproject, char* cache_path) {
     fproject->base.cache.loaded = 1;
     fproject->base.cache.root = path_from_string(cache_path);
     fproject->base.cache.files = set_new(sizeof(bld_file));
+    fproject->base.cache.builds = array_new(sizeof(bld_build_stats));
+    fproject->base.cache.link_fingerprint = 0;
+    fproject->base.cache.link_mtime = 0;
+    fproject->base.cache.build_recorded = 0;
+    fproject->base.cache.link_changed = 0;
+    fproject->base.cache.journal = 0;
+    fproject->base.cache.snapshot_size = 0;
+    fproject->base.cache.journal_size = 0;
 
     if (file == NULL) {
         log_debug("No cache file found.");
     } else {
         int error;
+        uintmax_t span;
+        bld_mem_phase phase;
 
         fclose(file);
         log_debug("Found cache file, attempting to parse.");
         fproject->base.cache.base = &fproject->base;
+
+        span = trace_begin();
+        phase = mem_phase(BLD_MEM_CACHE_LOAD);
         error = parse_cache(&fproject->base.cache, &fproject->base.root);
+        if (!error && !fproject->base.rebuilding) {
+            parse_journal(&fproject->base.cache, &fproject->base.root);
+        }
+        mem_phase(phase);
+        trace_end(span, BLD_TRACE_PHASE, "load cache", NULL, 0);
 
         if (error) {
             log_warn("Could not parse cache, ignoring.");
@@ -113,13 +170,15 @@ void project_load_cache(bld_forward_project* fproject, char* cache_path) {
 }
 
 int parse_cache(bld_project_cache* cache, bld_path* root) {
-    int size = 3;
-    int parsed[3];
-    char *keys[3] = {"linker", "files", "rebuild_main"};
-    bld_parse_func funcs[3] = {
+    int size = 5;
+    int parsed[5];
+    char *keys[5] = {"linker", "files", "rebuild_main", "builds", "link"};
+    bld_parse_func funcs[5] = {
         (bld_parse_func) parse_project_linker,
         (bld_parse_func) parse_project_files,
         (bld_parse_func) parse_project_rebuild_main,
+        (bld_parse_func) parse_project_builds,
+        (bld_parse_func) parse_project_link,
     };
     bld_path path;
     FILE* f;
@@ -127,7 +186,7 @@ int parse_cache(bld_project_cache* cache, bld_path* root) {
     path = path_copy(root);
     path_append_path(&path, &cache->root);
     path_append_string(&path, BLD_CACHE_NAME);
-    f = fopen(path_to_string(&path), "r");
+    f = json_open(path_to_string(&path));
 
     cache->root_file = BLD_INVALID_IDENITIFIER;
     json_parse_map(f, cache, size, parsed, keys, funcs);
@@ -155,9 +214,15 @@ int parse_cache(bld_project_cache* cache, bld_path* root) {
             log_fatal(LOG_FATAL_PREFIX "free correctly");
         }
 
+        cache->builds.size = 0;
+        cache->link_fingerprint = 0;
+        cache->link_mtime = 0;
         return -1;
     }
 
+    fseek(f, 0, SEEK_END);
+    cache->snapshot_size = ftell(f);
+
     fclose(f);
     path_free(&path);
     return 0;
@@ -172,6 +237,99 @@ int parse_project_linker(FILE* file, bld_project_cache* cache) {
     return error;
 }
 
+int parse_project_builds(FILE* file, bld_project_cache* cache) {
+    int amount_parsed;
+
+    amount_parsed = json_parse_array(file, &cache->builds, (bld_parse_func) parse_project_build);
+    if (amount_parsed < 0) {
+        cache->builds.size = 0;
+        log_warn("Could not parse build history");
+        return -1;
+    }
+
+    return 0;
+}
+
+int parse_project_build(FILE* file, bld_array* builds) {
+    int amount_parsed;
+    int size = 6;
+    int parsed[6];
+    char *keys[6] = {"wall_time", "cpu_time", "link_time", "compiled", "cached", "longest_compile"};
+    bld_parse_func funcs[6] = {
+        (bld_parse_func) parse_build_wall_time,
+        (bld_parse_func) parse_build_cpu_time,
+        (bld_parse_func) parse_build_link_time,
+        (bld_parse_func) parse_build_compiled,
+        (bld_parse_func) parse_build_cached,
+        (bld_parse_func) parse_build_longest_compile,
+    };
+    bld_build_stats stats;
+
+    /* Entries written before the longest compile was recorded leave it at 0 */
+    stats.longest_compile = 0;
+    amount_parsed = json_parse_map(file, &stats, size, parsed, keys, funcs);
+    if (amount_parsed < 0 || !parsed[0] || !parsed[1] || !parsed[2] || !parsed[3] || !parsed[4]) {
+        log_warn("Build history entry requires the following fields: [\"%s\", \"%s\", \"%s\", \"%s\", \"%s\"]", keys[0], keys[1], keys[2], keys[3], keys[4]);
+        return -1;
+    }
+
+    array_push(builds, &stats);
+    return 0;
+}
+
+int parse_build_wall_time(FILE* file, bld_build_stats* stats) {
+    return parse_uintmax(file, &stats->wall_time);
+}
+
+int parse_build_cpu_time(FILE* file, bld_build_stats* stats) {
+    return parse_uintmax(file, &stats->cpu_time);
+}
+
+int parse_build_link_time(FILE* file, bld_build_stats* stats) {
+    return parse_uintmax(file, &stats->link_time);
+}
+
+int parse_build_longest_compile(FILE* file, bld_build_stats* stats) {
+    return parse_uintmax(file, &stats->longest_compile);
+}
+
+int parse_build_compiled(FILE* file, bld_build_stats* stats) {
+    return parse_uintmax(file, &stats->compiled);
+}
+
+int parse_build_cached(FILE* file, bld_build_stats* stats) {
+    return parse_uintmax(file, &stats->cached);
+}
+
+int parse_project_link(FILE* file, bld_project_cache* cache) {
+    int amount_parsed;
+    int size = 2;
+    int parsed[2];
+    char *keys[2] = {"fingerprint", "mtime"};
+    bld_parse_func funcs[2] = {
+        (bld_parse_func) parse_link_fingerprint,
+        (bld_parse_func) parse_link_mtime,
+    };
+
+    amount_parsed = json_parse_map(file, cache, size, parsed, keys, funcs);
+    if (amount_parsed < size) {
+        cache->link_fingerprint = 0;
+        cache->link_mtime = 0;
+        log_warn("Link record requires the following fields: [\"%s\", \"%s\"]", keys[0], keys[1]);
+        return -1;
+    }
+
+    return 0;
+}
+
+int parse_link_fingerprint(FILE* file, bld_project_cache* cache) {
+    return parse_uintmax(file, &cache->link_fingerprint);
+}
+
+int parse_link_mtime(FILE* file, bld_project_cache* cache) {
+    return parse_uintmax(file, &cache->link_mtime);
+}
+
 int parse_project_files(FILE* file, bld_project_cache* cache) {
     int error;
     bld_parsing_file f;
@@ -180,6 +338,7 @@ int parse_project_files(FILE* file, bld_project_cache* cache) {
     f.parent = BLD_INVALID_IDENITIFIER;
     f.parent_path = NULL;
     f.is_rebuild_main = 0;
+    f.is_journal = 0;
 
     error = parse_file(file, &f);
     if (error) {
@@ -226,6 +385,7 @@ int parse_file(FILE* file, bld_parsing_file* f) {
         "includes",
         "defined_symbols",
         "undefined_symbols",
+        "compile_times",
         "files",
     };
     bld_parse_func funcs[BLD_TOTAL_FIELDS] = {
@@ -239,10 +399,12 @@ int parse_file(FILE* file, bld_parsing_file* f) {
         (bld_parse_func) parse_file_includes,
         (bld_parse_func) parse_file_defined_symbols,
         (bld_parse_func) parse_file_undefined_symbols,
+        (bld_parse_func) parse_file_compile_times,
         (bld_parse_func) parse_file_sub_files,
     };
 
     f->file.type = BLD_FILE_INVALID;
+    f->file.parent_id = f->parent;
     f->file.build_info.compiler_set = 0;
     f->file.build_info.linker_set = 0;
 
@@ -411,6 +573,15 @@ int parse_file(FILE* file, bld_parsing_file* f) {
     }
     undefined_freed:
 
+    if (parsed[BLD_PARSE_TYPE]) {
+        bld_array* times;
+
+        times = file_compile_times_get(&f->file);
+        if (times != NULL) {
+            array_free(times);
+        }
+    }
+
     return -1;
 }
 
@@ -432,11 +603,16 @@ int parse_file_type(FILE* file, bld_parsing_file* f) {
         f->file.type = BLD_FILE_IMPLEMENTATION;
         f->file.info.impl.undefined_symbols = set_new(sizeof(bld_string));
         f->file.info.impl.defined_symbols = set_new(sizeof(bld_string));
+        set_verify_keys(&f->file.info.impl.undefined_symbols, string_key_eq);
+        set_verify_keys(&f->file.info.impl.defined_symbols, string_key_eq);
+        f->file.info.impl.compile_times = array_new(sizeof(bld_time));
     } else if (strcmp(temp, "interface") == 0) {
         f->file.type = BLD_FILE_INTERFACE;
     } else if (strcmp(temp, "test") == 0) {
         f->file.type = BLD_FILE_TEST;
         f->file.info.test.undefined_symbols = set_new(sizeof(bld_string));
+        set_verify_keys(&f->file.info.test.undefined_symbols, string_key_eq);
+        f->file.info.test.compile_times = array_new(sizeof(bld_time));
     } else {
         log_warn("Not a valid file type: \"%s\"", temp);
         error = -1;
@@ -485,7 +661,7 @@ int parse_file_name(FILE* file, bld_parsing_file* f) {
     }
 
     if (f->parent_path == NULL) {
-        if (!f->is_rebuild_main) {
+        if (!f->is_rebuild_main && !f->is_journal) {
             f->file.path = path_from_string(".");
         } else {
             f->file.path = path_from_string(string_unpack(&str));
@@ -510,7 +686,8 @@ int parse_file_name(FILE* file, bld_parsing_file* f) {
         }
         path_append_path(&path, &f->file.path);
 
-        file_id = file_get_id(&path);
+        /* Files removed since the cache was written are dropped by parse_file */
+        file_id = os_info_id(path_to_string(&path));
         f->file.identifier.id = file_id;
 
         path_free(&path);
@@ -633,6 +810,36 @@ int parse_file_include(FILE* file, bld_array* array) {
     return 0;
 }
 
+int parse_file_compile_times(FILE* file, bld_parsing_file* f) {
+    int amount_parsed;
+    bld_array* times;
+
+    if (f->file.type != BLD_FILE_IMPLEMENTATION && f->file.type != BLD_FILE_TEST) {
+        log_warn("Could not parse compile times, file type is not compiled");
+        return -1;
+    }
+
+    times = file_compile_times_get(&f->file);
+    amount_parsed = json_parse_array(file, times, (bld_parse_func) parse_file_compile_time);
+    if (amount_parsed < 0) {
+        log_warn("Could not parse compile times");
+        return -1;
+    }
+
+    return 0;
+}
+
+int parse_file_compile_time(FILE* file, bld_array* times) {
+    int error;
+    bld_time duration;
+
+    error = parse_uintmax(file, &duration);
+    if (error) {return -1;}
+
+    array_push(times, &duration);
+    return 0;
+}
+
 int parse_file_defined_symbols(FILE* file, bld_parsing_file* f) {
     bld_set* defined;
     int amount_parsed;
@@ -732,11 +939,13 @@ int parse_file_sub_file(FILE* file, bld_parsing_file* f) {
     sub_file.parent = f->file.identifier.id;
     sub_file.parent_path = &f->file.path;
     sub_file.is_rebuild_main = 0;
+    sub_file.is_journal = 0;
     error = parse_file(file, &sub_file);
     if (error) {
         return -1;
     }
 
+    if (sub_file.file.identifier.id == BLD_INVALID_IDENITIFIER) {return 0;}
     file_dir_add_file(&f->file, &sub_file.file);
     return 0;
 }
@@ -759,11 +968,14 @@ int parse_project_rebuild_main(FILE* file, bld_project_cache* cache) {
     f.parent = cache->root_file;
     f.parent_path = NULL;
     f.is_rebuild_main = 1;
+    f.is_journal = 0;
     error = parse_file(file, &f);
     if (error) {
         return -1;
     }
 
+    if (f.file.identifier.id == BLD_INVALID_IDENITIFIER) {return 0;}
+
     root = set_get(&cache->files, cache->root_file);
     if (root == NULL) {
         log_error(LOG_FATAL_PREFIX "unreachable error");
@@ -773,3 +985,276 @@ int parse_project_rebuild_main(FILE* file, bld_project_cache* cache) {
     file_dir_add_file(root, &f.file);
     return 0;
 }
+
+int parse_journal(bld_project_cache* cache, bld_path* root) {
+    int c, error, inconsistent;
+    bld_parsing_journal journal;
+    bld_path path;
+    bld_file* root_file;
+    FILE* f;
+
+    path = path_copy(root);
+    path_append_path(&path, &cache->root);
+    path_append_string(&path, BLD_JOURNAL_NAME);
+    f = json_open(path_to_string(&path));
+    path_free(&path);
+
+    cache->journal_size = 0;
+    if (f == NULL) {
+        cache->journal = 1;
+        return 0;
+    }
+
+    error = 0;
+    inconsistent = 0;
+    while ((c = next_character(f)) != EOF) {
+        ungetc(c, f);
+
+        journal.cache = cache;
+        journal.entries.base = cache->base;
+        journal.entries.files = set_new(sizeof(bld_file));
+        journal.entries.builds = array_new(sizeof(bld_build_stats));
+        journal.removed = array_new(sizeof(bld_path));
+        journal.has_build = 0;
+        journal.has_link = 0;
+        journal.inconsistent = 0;
+
+        error = parse_journal_record(f, &journal);
+        if (error) {
+            log_warn("Could not parse cache journal, ignoring remaining entries.");
+            parse_journal_free(&journal);
+            break;
+        }
+
+        parse_journal_apply(&journal);
+        inconsistent = inconsistent || journal.inconsistent;
+    }
+
+    cache->journal_size = ftell(f);
+    fclose(f);
+
+    root_file = set_get(&cache->files, cache->root_file);
+    if (root_file == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
+    file_determine_all_languages_under(root_file, &cache->files);
+
+    cache->journal = !error && !inconsistent && cache->journal_size * BLD_JOURNAL_COMPACT_RATIO <= cache->snapshot_size;
+    if (!cache->journal) {
+        log_debug("Cache journal will be compacted into a new snapshot.");
+    }
+
+    return error;
+}
+
+int parse_journal_record(FILE* file, bld_parsing_journal* journal) {
+    int amount_parsed;
+    int size = 4;
+    int parsed[4];
+    char *keys[4] = {"files", "removed", "build", "link"};
+    bld_parse_func funcs[4] = {
+        (bld_parse_func) parse_journal_files,
+        (bld_parse_func) parse_journal_removed,
+        (bld_parse_func) parse_journal_build,
+        (bld_parse_func) parse_journal_link,
+    };
+
+    /* Every key is optional, a record of a no-op build only holds the build */
+    amount_parsed = json_parse_map(file, journal, size, parsed, keys, funcs);
+    if (amount_parsed <= 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int parse_journal_files(FILE* file, bld_parsing_journal* journal) {
+    int amount_parsed;
+
+    amount_parsed = json_parse_array(file, journal, (bld_parse_func) parse_journal_file);
+    if (amount_parsed < 0) {return -1;}
+
+    return 0;
+}
+
+int parse_journal_file(FILE* file, bld_parsing_journal* journal) {
+    bld_parsing_file f;
+
+    f.cache = &journal->entries;
+    f.parent = BLD_INVALID_IDENITIFIER;
+    f.parent_path = NULL;
+    f.is_rebuild_main = 0;
+    f.is_journal = 1;
+
+    return parse_file(file, &f);
+}
+
+int parse_journal_removed(FILE* file, bld_parsing_journal* journal) {
+    int amount_parsed;
+
+    amount_parsed = json_parse_array(file, &journal->removed, (bld_parse_func) parse_file_include);
+    if (amount_parsed < 0) {return -1;}
+
+    return 0;
+}
+
+int parse_journal_build(FILE* file, bld_parsing_journal* journal) {
+    int error;
+
+    error = parse_project_build(file, &journal->entries.builds);
+    if (error) {return -1;}
+
+    journal->has_build = 1;
+    return 0;
+}
+
+int parse_journal_link(FILE* file, bld_parsing_journal* journal) {
+    int error;
+
+    error = parse_project_link(file, &journal->entries);
+    if (error) {return -1;}
+
+    journal->has_link = 1;
+    return 0;
+}
+
+void parse_journal_apply(bld_parsing_journal* journal) {
+    bld_iter iter;
+    bld_file* entry;
+    bld_path* path;
+
+    iter = iter_set(&journal->entries.files);
+    while (iter_next(&iter, (void**) &entry)) {
+        parse_journal_apply_file(journal, entry);
+    }
+    set_free(&journal->entries.files);
+
+    iter = iter_array(&journal->removed);
+    while (iter_next(&iter, (void**) &path)) {
+        parse_journal_apply_removed(journal, path);
+        path_free(path);
+    }
+    array_free(&journal->removed);
+
+    /* A record holds only the build that wrote it, the history is rebuilt here */
+    if (journal->has_build) {
+        if (journal->cache->builds.size >= BLD_BUILD_HISTORY) {
+            array_remove(&journal->cache->builds, 0);
+        }
+        array_push(&journal->cache->builds, array_get(&journal->entries.builds, 0));
+    }
+    array_free(&journal->entries.builds);
+
+    if (journal->has_link) {
+        journal->cache->link_fingerprint = journal->entries.link_fingerprint;
+        journal->cache->link_mtime = journal->entries.link_mtime;
+    }
+}
+
+void parse_journal_apply_file(bld_parsing_journal* journal, bld_file* entry) {
+    bld_file *cached, *parent;
+    bld_set* files;
+    bld_path path;
+    bld_string name;
+
+    files = &journal->cache->files;
+    if (entry->type == BLD_FILE_DIRECTORY) {
+        journal->inconsistent = 1;
+        file_free(entry);
+        return;
+    }
+
+    /* Entries are stored under their full path, known files keep their place in the tree */
+    cached = set_get(files, entry->identifier.id);
+    if (cached != NULL) {
+        name = cached->name;
+        cached->name = entry->name;
+        entry->name = name;
+
+        path = cached->path;
+        cached->path = entry->path;
+        entry->path = path;
+
+        entry->parent_id = cached->parent_id;
+        file_free(cached);
+        *cached = *entry;
+        return;
+    }
+
+    path = path_copy(&journal->cache->base->root);
+    path_append_path(&path, &entry->path);
+    path_remove_last_string(&path);
+    parent = set_get(files, os_info_id(path_to_string(&path)));
+    path_free(&path);
+
+    if (parent == NULL || parent->type != BLD_FILE_DIRECTORY) {
+        journal->inconsistent = 1;
+        file_free(entry);
+        return;
+    }
+
+    name = string_pack(path_get_last_string(&entry->path));
+    name = string_copy(&name);
+    string_free(&entry->name);
+    entry->name = name;
+
+    file_dir_add_file(parent, entry);
+    set_add(files, entry->identifier.id, entry);
+}
+
+void parse_journal_apply_removed(bld_parsing_journal* journal, bld_path* removed) {
+    bld_file_id id;
+    bld_file file, *cached;
+    bld_path path;
+
+    path = path_copy(&journal->cache->base->root);
+    path_append_path(&path, removed);
+    id = os_info_id(path_to_string(&path));
+    path_free(&path);
+
+    cached = set_get(&journal->cache->files, id);
+    if (cached == NULL) {return;}
+    if (cached->type == BLD_FILE_DIRECTORY) {
+        journal->inconsistent = 1;
+        return;
+    }
+
+    parse_journal_detach(&journal->cache->files, cached);
+    file = *cached;
+    set_remove(&journal->cache->files, id);
+    file_free(&file);
+}
+
+void parse_journal_detach(bld_set* files, bld_file* file) {
+    size_t i;
+    bld_file* parent;
+    bld_file_id* child;
+
+    parent = set_get(files, file->parent_id);
+    if (parent == NULL) {return;}
+
+    for (i = 0; i < parent->info.dir.files.size; i++) {
+        child = array_get(&parent->info.dir.files, i);
+        if (*child != file->identifier.id) {continue;}
+
+        array_remove(&parent->info.dir.files, i);
+        break;
+    }
+}
+
+void parse_journal_free(bld_parsing_journal* journal) {
+    bld_iter iter;
+    bld_file* file;
+    bld_path* path;
+
+    iter = iter_set(&journal->entries.files);
+    while (iter_next(&iter, (void**) &file)) {
+        file_free(file);
+    }
+    set_free(&journal->entries.files);
+    array_free(&journal->entries.builds);
+
+    iter = iter_array(&journal->removed);
+    while (iter_next(&iter, (void**) &path)) {
+        path_free(path);
+    }
+    array_free(&journal->removed);
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
+#include "os.h"
 #include "logging.h"
 #include "file.h"
 #include "project.h"
@@ -16,7 +17,6 @@ void                project_cache_free(bld_project_cache*);
 bld_string          extract_build_name(bld_path*);
 
 bld_forward_project project_new(bld_path path, bld_compiler compiler, bld_linker linker) {
-    FILE* f;
     bld_path build_file_path;
     bld_string build_file_name;
     bld_forward_project fproject;
@@ -26,11 +26,8 @@ bld_forward_project project_new(bld_path path, bld_compiler compiler, bld_linker
     build_file_path = path_copy(&path);
     path_append_string(&build_file_path, string_unpack(&build_file_name));
 
-    f = fopen(path_to_string(&build_file_path), "r");
-    if (f == NULL) {
+    if (!os_file_exists(path_to_string(&build_file_path))) {
         log_fatal("Expected executable to have same name (and be in same directory) as build file. Could not find \"%s\"", path_to_string(&build_file_path));
-    } else {
-        fclose(f);
     }
 
     fproject = project_forward_new(&path, &compiler, &linker);
@@ -181,6 +178,8 @@ void project_free(bld_project* project) {
         file_free(file);
     }
     set_free(&project->files);
+    file_resolutions_free(&project->resolutions);
+    set_free(&project->fingerprints);
 }
 
 void project_partial_free(bld_forward_project* fproject) {
@@ -216,6 +215,7 @@ bld_project_base project_base_new(bld_path* path, bld_linker* linker) {
     base.compiler_handles = set_new(sizeof(bld_compiler_type));
     base.linker = *linker;
     base.cache = project_cache_new();
+    base.jobs = os_cpu_count();
 
     return base;
 }
@@ -236,6 +236,7 @@ bld_project_cache project_cache_new(void) {
     cache.loaded = 0;
     cache.set = 0;
     cache.applied = 0;
+    cache.journal = 0;
 
     return cache;
 }
@@ -246,6 +247,7 @@ void project_cache_free(bld_project_cache* cache) {
 
     if (!cache->loaded) {return;}
     path_free(&cache->root);
+    array_free(&cache->builds);
 
     if (!cache->set) {return;}
     linker_free(&cache->linker);
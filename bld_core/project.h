@@ -10,6 +10,8 @@
 #include "project_base.h"
 
 #define BLD_CACHE_NAME "cache.json"
+#define BLD_JOURNAL_NAME "journal.json"
+#define BLD_JOURNAL_COMPACT_RATIO (2)
 
 typedef struct bld_forward_project {
     int resolved;
@@ -29,7 +31,10 @@ typedef struct bld_project {
     uintmax_t main_file;
     uintmax_t root_dir;
     bld_set files;
+    bld_set resolutions;
+    bld_set fingerprints;
     bld_dependency_graph graph;
+    bld_build_stats stats;
 } bld_project;
 
 bld_path    project_path_extract(int, char**);
@@ -5,6 +5,17 @@
 #include "set.h"
 #include "linker.h"
 
+#define BLD_BUILD_HISTORY (8)
+
+typedef struct bld_build_stats {
+    uintmax_t wall_time;
+    uintmax_t cpu_time;
+    uintmax_t link_time;
+    uintmax_t longest_compile;
+    uintmax_t compiled;
+    uintmax_t cached;
+} bld_build_stats;
+
 typedef struct bld_project_cache bld_project_cache;
 typedef struct bld_project_base bld_project_base;
 
@@ -17,6 +28,14 @@ struct bld_project_cache {
     uintmax_t root_file;
     bld_linker linker;
     bld_set files;
+    bld_array builds;
+    bld_hash link_fingerprint;
+    uintmax_t link_mtime;
+    int build_recorded;
+    int link_changed;
+    int journal;
+    long snapshot_size;
+    long journal_size;
 };
 
 struct bld_project_base {
@@ -28,6 +47,7 @@ struct bld_project_base {
     bld_set compiler_handles;
     bld_linker linker;
     bld_project_cache cache;
+    int jobs;
 };
 
 #endif
@@ -1,17 +1,30 @@
 #include <stdio.h>
 #include <string.h>
 #include "logging.h"
+#include "json.h"
 #include "incremental.h"
 #include "rebuild.h"
 
-int                 run_new_build(bld_path*, char*);
+void                run_new_build(bld_path*, char*, char**);
 bld_forward_project new_rebuild(bld_forward_project*, bld_path, bld_compiler, bld_linker);
 void                extract_names(int, char**, char**, char**);
 char*               infer_build_name(char*);
 void                set_main_rebuild(bld_forward_project*, bld_path*);
 
-int run_new_build(bld_path* root, char* executable) {
-    int result;
+bld_path            manifest_path(bld_path*, char*);
+uintmax_t           manifest_modified(char*);
+bld_manifest        manifest_new(void);
+void                manifest_add_files(bld_manifest*, bld_project*, int);
+void                manifest_free(bld_manifest*);
+int                 manifest_current(bld_path*, bld_path*);
+void                manifest_save(bld_manifest*, bld_path*);
+int                 parse_manifest_executable(FILE*, bld_manifest*);
+int                 parse_manifest_files(FILE*, bld_manifest*);
+int                 parse_manifest_file(FILE*, bld_array*);
+int                 parse_manifest_file_path(FILE*, bld_manifest_entry*);
+int                 parse_manifest_file_mtime(FILE*, bld_manifest_entry*);
+
+void run_new_build(bld_path* root, char* executable, char** argv) {
     bld_path cmd;
 
     cmd = path_copy(root);
@@ -19,10 +32,11 @@ int run_new_build(bld_path* root, char* executable) {
 
     log_info("Running new build script");
     log_debug("Rebuild command: \"%s\"", path_to_string(&cmd));
-    result = system(path_to_string(&cmd));
 
-    path_free(&cmd);
-    return result;
+    /* Arguments are handed over unchanged, only the program is swapped */
+    argv[0] = path_to_string(&cmd);
+    os_process_replace(path_to_string(&cmd), argv);
+    log_fatal("Could not run new build script \"%s\"", path_to_string(&cmd));
 }
 
 bld_forward_project new_rebuild(bld_forward_project* fproject, bld_path root, bld_compiler compiler, bld_linker linker) {
@@ -73,16 +87,195 @@ void set_main_rebuild(bld_forward_project* build, bld_path* path) {
     build->main_file_name = str;
 }
 
-void    project_base_free(bld_project_base*);
+bld_path manifest_path(bld_path* build_root, char* executable) {
+    bld_path path;
+
+    path = path_copy(build_root);
+    path_append_string(&path, ".build_cache");
+    path_append_string(&path, executable);
+    string_append_string(&path.str, ".manifest");
+    return path;
+}
+
+uintmax_t manifest_modified(char* path) {
+    bld_os_stat info;
+
+    if (os_stat(path, &info) < 0 || info.type == BLD_OS_STAT_MISSING) {return 0;}
+    return info.mtime_ns;
+}
+
+bld_manifest manifest_new(void) {
+    bld_manifest manifest;
+
+    manifest.executable = 0;
+    manifest.files = array_new(sizeof(bld_manifest_entry));
+    return manifest;
+}
+
+void manifest_add_files(bld_manifest* manifest, bld_project* build, int directories) {
+    bld_iter iter;
+    bld_file* file;
+    bld_manifest_entry entry;
+
+    iter = iter_set(&build->files);
+    while (iter_next(&iter, (void**) &file)) {
+        if ((file->type == BLD_FILE_DIRECTORY) != directories) {continue;}
+
+        if (file->identifier.id == build->main_file) {
+            entry.path = path_copy(&build->base.build_of->root);
+        } else {
+            entry.path = path_copy(&build->base.root);
+        }
+        path_append_path(&entry.path, &file->path);
+        entry.mtime = manifest_modified(path_to_string(&entry.path));
+        array_push(&manifest->files, &entry);
+    }
+}
+
+void manifest_free(bld_manifest* manifest) {
+    bld_iter iter;
+    bld_manifest_entry* entry;
+
+    iter = iter_array(&manifest->files);
+    while (iter_next(&iter, (void**) &entry)) {
+        path_free(&entry->path);
+    }
+    array_free(&manifest->files);
+}
+
+int manifest_current(bld_path* path, bld_path* executable) {
+    int amount_parsed, current;
+    int size = 2;
+    int parsed[2];
+    char *keys[2] = {"executable", "files"};
+    bld_parse_func funcs[2] = {
+        (bld_parse_func) parse_manifest_executable,
+        (bld_parse_func) parse_manifest_files,
+    };
+    FILE* file;
+    bld_iter iter;
+    bld_manifest manifest;
+    bld_manifest_entry* entry;
+
+    file = json_open(path_to_string(path));
+    if (file == NULL) {return 0;}
+
+    manifest = manifest_new();
+    amount_parsed = json_parse_map(file, &manifest, size, parsed, keys, funcs);
+    fclose(file);
+
+    current = amount_parsed == size
+        && manifest.executable != 0
+        && manifest.executable == manifest_modified(path_to_string(executable));
+
+    iter = iter_array(&manifest.files);
+    while (current && iter_next(&iter, (void**) &entry)) {
+        current = entry->mtime != 0 && entry->mtime == manifest_modified(path_to_string(&entry->path));
+    }
+
+    manifest_free(&manifest);
+    return current;
+}
+
+void manifest_save(bld_manifest* manifest, bld_path* path) {
+    int first;
+    FILE* file;
+    bld_iter iter;
+    bld_manifest_entry* entry;
+
+    file = json_create(path_to_string(path));
+    if (file == NULL) {
+        log_warn("Could not save manifest of build script");
+        return;
+    }
+
+    fputs("{\n  \"executable\": ", file);
+    json_serialize_uintmax(file, manifest->executable);
+    fputs(",\n  \"files\": [\n", file);
+
+    first = 1;
+    iter = iter_array(&manifest->files);
+    while (iter_next(&iter, (void**) &entry)) {
+        if (!first) {
+            fputs(",\n", file);
+        } else {
+            first = 0;
+        }
+        json_serialize_indent(file, 4);
+        fputs("{\"path\": ", file);
+        json_serialize_string(file, path_to_string(&entry->path));
+        fputs(", \"mtime\": ", file);
+        json_serialize_uintmax(file, entry->mtime);
+        fputc('}', file);
+    }
+
+    fputs("\n  ]\n}\n", file);
+    fclose(file);
+}
+
+int parse_manifest_executable(FILE* file, bld_manifest* manifest) {
+    return parse_uintmax(file, &manifest->executable);
+}
+
+int parse_manifest_files(FILE* file, bld_manifest* manifest) {
+    int amount_parsed;
+
+    amount_parsed = json_parse_array(file, &manifest->files, (bld_parse_func) parse_manifest_file);
+    if (amount_parsed < 0) {
+        log_debug("Could not parse files of build script manifest");
+        return -1;
+    }
+
+    return 0;
+}
+
+int parse_manifest_file(FILE* file, bld_array* files) {
+    int amount_parsed;
+    int size = 2;
+    int parsed[2];
+    char *keys[2] = {"path", "mtime"};
+    bld_parse_func funcs[2] = {
+        (bld_parse_func) parse_manifest_file_path,
+        (bld_parse_func) parse_manifest_file_mtime,
+    };
+    bld_manifest_entry entry;
+
+    amount_parsed = json_parse_map(file, &entry, size, parsed, keys, funcs);
+    if (amount_parsed < size) {
+        if (parsed[0]) {path_free(&entry.path);}
+        return -1;
+    }
+
+    array_push(files, &entry);
+    return 0;
+}
+
+int parse_manifest_file_path(FILE* file, bld_manifest_entry* entry) {
+    int error;
+    bld_string str;
+
+    error = string_parse(file, &str);
+    if (error) {return -1;}
+
+    entry->path = path_from_string(string_unpack(&str));
+    string_free(&str);
+    return 0;
+}
+
+int parse_manifest_file_mtime(FILE* file, bld_manifest_entry* entry) {
+    return parse_uintmax(file, &entry->mtime);
+}
+
 int     incremental_compile_with_absolute_path(bld_project*, char*);
 void rebuild_builder(bld_forward_project* fproject, int argc, char** argv) {
-    int result, new_result, log_level;
+    int result, log_level;
     char *executable, *old_executable, *main_name;
-    bld_path build_root, main, executable_path;
+    bld_path build_root, main, executable_path, manifest_file;
     bld_forward_project fbuild;
     bld_project build;
     bld_compiler compiler;
     bld_linker linker;
+    bld_manifest manifest;
 
     if (fproject->base.standalone) {
         log_fatal("rebuild_builder: attempting to rebuild build script but not build path has been set");
@@ -103,6 +296,24 @@ void rebuild_builder(bld_forward_project* fproject, int argc, char** argv) {
     path_append_path(&build_root, &fproject->base.build);
     log_debug("Root: \"%s\"", path_to_string(&build_root));
 
+    executable_path = path_copy(&fproject->base.root);
+    path_append_string(&executable_path, executable);
+
+    /* A build script is run far more often than it is edited, the stats in the manifest spare resolving the build path */
+    manifest_file = manifest_path(&build_root, executable);
+    if (manifest_current(&manifest_file, &executable_path)) {
+        log_debug("Build script manifest is current");
+
+        free(executable);
+        free(old_executable);
+        free(main_name);
+        path_free(&build_root);
+        path_free(&executable_path);
+        path_free(&manifest_file);
+        set_log_level(log_level);
+        return;
+    }
+
     compiler = compiler_new(BLD_COMPILER_GCC, "gcc");
     compiler_add_flag(&compiler, "-std=c89");
     compiler_add_flag(&compiler, "-fsanitize=address");
@@ -115,9 +326,11 @@ void rebuild_builder(bld_forward_project* fproject, int argc, char** argv) {
 
     linker = linker_new(BLD_LINKER_GCC, "gcc");
     linker_add_flag(&linker, "-fsanitize=address");
+    linker_add_flag(&linker, "-pthread");
 
     fbuild = new_rebuild(fproject, build_root, compiler, linker);
     project_ignore_path(&fbuild, "./test");
+    project_ignore_path(&fbuild, "./bench");
 
     main = path_copy(&fproject->base.root);
     path_append_string(&main, main_name);
@@ -127,8 +340,9 @@ void rebuild_builder(bld_forward_project* fproject, int argc, char** argv) {
 
     build = project_resolve(&fbuild);
 
-    executable_path = path_copy(&fproject->base.root);
-    path_append_string(&executable_path, executable);
+    /* Sources are stated before compiling so an edit made during the compilation is seen next run */
+    manifest = manifest_new();
+    manifest_add_files(&manifest, &build, 0);
 
     {
         bld_path temp1, temp2;
@@ -156,26 +370,27 @@ void rebuild_builder(bld_forward_project* fproject, int argc, char** argv) {
 
     project_save_cache(&build);
 
-    if (result == 0) {
-        set_log_level(BLD_INFO);
-        log_info("Recompiled build script");
-        new_result = run_new_build(&fproject->base.root, executable);
-    } else {
-        new_result = -1;
-    }
+    /* Directories are stated last, the renamed executable or the cache may live in one of them */
+    manifest_add_files(&manifest, &build, 1);
+
+    os_stat_forget(path_to_string(&executable_path));
+    manifest.executable = manifest_modified(path_to_string(&executable_path));
+    manifest_save(&manifest, &manifest_file);
 
-    free(executable);
     free(old_executable);
     free(main_name);
     path_free(&executable_path);
+    path_free(&manifest_file);
     path_free(&main);
+    manifest_free(&manifest);
     project_free(&build);
 
     if (result == 0) {
-        project_base_free(&fproject->base);
-        project_partial_free(fproject);
-        exit(new_result);
+        set_log_level(BLD_INFO);
+        log_info("Recompiled build script");
+        run_new_build(&fproject->base.root, executable, argv);
     }
 
+    free(executable);
     set_log_level(log_level);
 }
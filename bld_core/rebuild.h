@@ -3,6 +3,16 @@
 
 #include "project.h"
 
+typedef struct bld_manifest_entry {
+    bld_path path;
+    uintmax_t mtime;
+} bld_manifest_entry;
+
+typedef struct bld_manifest {
+    uintmax_t executable;
+    bld_array files;
+} bld_manifest;
+
 void rebuild_builder(bld_forward_project*, int, char**);
 
 #endif
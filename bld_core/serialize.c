@@ -1,5 +1,7 @@
 #include <inttypes.h>
 #include "logging.h"
+#include "trace.h"
+#include "mem.h"
 #include "project.h"
 #include "json.h"
 
@@ -11,11 +13,21 @@ void serialize_file_id(FILE*, bld_file_identifier);
 void serialize_file_mtime(FILE*, bld_file_identifier);
 void serialize_file_symbols(FILE*, bld_set*, int);
 void serialize_file_includes(FILE*, bld_set*, int);
+void serialize_file_compile_times(FILE*, bld_array*);
+void serialize_builds(FILE*, bld_array*, int);
+void serialize_build(FILE*, bld_build_stats*);
+void serialize_link(FILE*, bld_project_cache*);
+int serialize_journal_possible(bld_project*);
+int serialize_journal_kept(bld_project*, bld_file*);
+int serialize_journal_changed(bld_file*, bld_file*);
+void serialize_journal(bld_project*);
 
 void project_save_cache(bld_project* project) {
     FILE* cache;
-    bld_path cache_path;
+    bld_path cache_path, journal_path;
     bld_file* root;
+    uintmax_t span;
+    bld_mem_phase phase;
     int depth = 1;
 
     if (!project->base.cache.loaded) {
@@ -24,35 +36,66 @@ void project_save_cache(bld_project* project) {
     root = set_get(&project->files, project->root_dir);
     if (root == NULL) {log_fatal("project_save_cache: internal error");}
 
+    if (serialize_journal_possible(project)) {
+        span = trace_begin();
+        phase = mem_phase(BLD_MEM_SAVE);
+        serialize_journal(project);
+        mem_phase(phase);
+        trace_end(span, BLD_TRACE_PHASE, "save journal", NULL, 0);
+        return;
+    }
+
+    span = trace_begin();
+    phase = mem_phase(BLD_MEM_SAVE);
+    journal_path = path_copy(&project->base.root);
+    path_append_path(&journal_path, &project->base.cache.root);
+    path_append_string(&journal_path, BLD_JOURNAL_NAME);
+    remove(path_to_string(&journal_path));
+    path_free(&journal_path);
+
     cache_path = path_copy(&project->base.root);
     path_append_path(&cache_path, &project->base.cache.root);
     path_append_string(&cache_path, BLD_CACHE_NAME);
 
-    cache = fopen(path_to_string(&cache_path), "w");
+    cache = json_create(path_to_string(&cache_path));
     if (cache == NULL) {
         log_fatal("Could not open cache file for writing under: \"%s\"", path_to_string(&cache_path));
     }
 
-    fprintf(cache, "{\n");
+    fputs("{\n", cache);
     json_serialize_key(cache, "linker", depth);
     serialize_linker(cache, &project->base.linker, depth + 1);
 
-    fprintf(cache, ",\n");
+    fputs(",\n", cache);
     json_serialize_key(cache, "files", depth);
     if (!project->base.rebuilding) {
         serialize_files(cache, BLD_INVALID_IDENITIFIER, root, &project->files, depth + 1);
     } else if (project->base.rebuilding) {
         serialize_files(cache, project->main_file, root, &project->files, depth + 1);
 
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "rebuild_main", depth);
         serialize_rebuild_main(cache, project, depth + 1);
     }
 
-    fprintf(cache, "\n}\n");
+    if (project->base.cache.builds.size > 0) {
+        fputs(",\n", cache);
+        json_serialize_key(cache, "builds", depth);
+        serialize_builds(cache, &project->base.cache.builds, depth + 1);
+    }
+
+    if (project->base.cache.link_fingerprint != 0) {
+        fputs(",\n", cache);
+        json_serialize_key(cache, "link", depth);
+        serialize_link(cache, &project->base.cache);
+    }
+
+    fputs("\n}\n", cache);
 
     fclose(cache);
     path_free(&cache_path);
+    mem_phase(phase);
+    trace_end(span, BLD_TRACE_PHASE, "save cache", NULL, 0);
 }
 
 void serialize_rebuild_main(FILE* cache, bld_project* project, int depth) {
@@ -71,31 +114,31 @@ void serialize_files(FILE* cache, uintmax_t main, bld_file* root, bld_set* files
 }
 
 void serialize_file(FILE* cache, uintmax_t main, bld_file* file, bld_set* files, int depth) {
-    fprintf(cache, "{\n");
+    fputs("{\n", cache);
 
     json_serialize_key(cache, "type", depth);
     serialize_file_type(cache, file->type);
 
     if (file->type != BLD_FILE_DIRECTORY) {
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "mtime", depth);
         serialize_file_mtime(cache, file->identifier);
 
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "hash", depth);
-        fprintf(cache, "%" PRIuMAX, file->identifier.hash);
+        json_serialize_uintmax(cache, file->identifier.hash);
     }
 
-    fprintf(cache, ",\n");
+    fputs(",\n", cache);
     json_serialize_key(cache, "name", depth);
     if (file->identifier.id != main) {
-        fprintf(cache, "\"%s\"", string_unpack(&file->name));
+        json_serialize_string(cache, string_unpack(&file->name));
     } else {
-        fprintf(cache, "\"%s\"", path_to_string(&file->path));
+        json_serialize_string(cache, path_to_string(&file->path));
     }
 
     if (file->build_info.compiler_set) {
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         switch (file->build_info.compiler.type) {
             case (BLD_COMPILER): {
                 json_serialize_key(cache, "compiler", depth);
@@ -109,7 +152,7 @@ void serialize_file(FILE* cache, uintmax_t main, bld_file* file, bld_set* files,
     }
 
     if (file->build_info.linker_set) {
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "linker_flags", depth);
         serialize_linker_flags(cache, &file->build_info.linker_flags, depth + 1);
     }
@@ -119,7 +162,7 @@ void serialize_file(FILE* cache, uintmax_t main, bld_file* file, bld_set* files,
         includes = file_includes_get(file);
         if (includes == NULL) {goto no_serialize_includes;}
 
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "includes", depth);
         serialize_file_includes(cache, includes, depth + 1);
     }
@@ -130,7 +173,7 @@ void serialize_file(FILE* cache, uintmax_t main, bld_file* file, bld_set* files,
         undefined = file_undefined_get(file);
         if (undefined == NULL) {goto no_serialize_undefined;}
 
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
 
         json_serialize_key(cache, "undefined_symbols", depth);
         serialize_file_symbols(cache, undefined, depth + 1);
@@ -142,23 +185,34 @@ void serialize_file(FILE* cache, uintmax_t main, bld_file* file, bld_set* files,
         defined = file_defined_get(file);
         if (defined == NULL) {goto no_serialize_defined;}
 
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "defined_symbols", depth);
         serialize_file_symbols(cache, defined, depth + 1);
     }
     no_serialize_defined:
 
+    {
+        bld_array* times;
+        times = file_compile_times_get(file);
+        if (times == NULL || times->size == 0) {goto no_serialize_compile_times;}
+
+        fputs(",\n", cache);
+        json_serialize_key(cache, "compile_times", depth);
+        serialize_file_compile_times(cache, times);
+    }
+    no_serialize_compile_times:
+
     if (file->type == BLD_FILE_DIRECTORY) {
         int first = 1;
         bld_iter iter;
         uintmax_t* child_id;
         bld_file* child;
 
-        fprintf(cache, ",\n");
+        fputs(",\n", cache);
         json_serialize_key(cache, "files", depth);
-        fprintf(cache, "[");
+        fputc('[', cache);
         if (file->info.dir.files.size > 0) {
-            fprintf(cache, "\n");
+            fputc('\n', cache);
         }
 
         iter = iter_array(&file->info.dir.files);
@@ -169,48 +223,50 @@ void serialize_file(FILE* cache, uintmax_t main, bld_file* file, bld_set* files,
             if ((child->type == BLD_FILE_IMPLEMENTATION || child->type == BLD_FILE_TEST) && !child->compile_successful) {continue;}
 
             if (!first) {
-                fprintf(cache, ",\n");
+                fputs(",\n", cache);
             } else {
                 first = 0;
             }
-            fprintf(cache, "%*c", 2 * (depth + 1), ' ');
+            json_serialize_indent(cache, 2 * (depth + 1));
             serialize_file(cache, main, child, files, depth + 2);
         }
 
         if (file->info.dir.files.size > 0) {
-            fprintf(cache, "\n%*c", 2 * depth, ' ');
+            fputc('\n', cache);
+            json_serialize_indent(cache, 2 * depth);
         }
-        fprintf(cache, "]");
+        fputc(']', cache);
     }
 
-    fprintf(cache, "\n");
-    fprintf(cache, "%*c}", 2 * (depth - 1), ' ');
+    fputc('\n', cache);
+    json_serialize_indent(cache, 2 * (depth - 1));
+    fputc('}', cache);
 }
 
 void serialize_file_type(FILE* cache, bld_file_type type) {
     switch (type) {
         case (BLD_FILE_DIRECTORY): {
-            fprintf(cache, "\"directory\"");
+            fputs("\"directory\"", cache);
         } break;
         case (BLD_FILE_IMPLEMENTATION): {
-            fprintf(cache, "\"implementation\"");
+            fputs("\"implementation\"", cache);
         } break;
         case (BLD_FILE_INTERFACE): {
-            fprintf(cache, "\"interface\"");
+            fputs("\"interface\"", cache);
         } break;
         case (BLD_FILE_TEST): {
-            fprintf(cache, "\"test\"");
+            fputs("\"test\"", cache);
         } break;
         default: log_fatal("serialize_file_type: unreachable error???");
     }
 }
 
 void serialize_file_id(FILE* cache, bld_file_identifier id) {
-    fprintf(cache, "%" PRIuMAX, id.id);
+    json_serialize_uintmax(cache, id.id);
 }
 
 void serialize_file_mtime(FILE* cache, bld_file_identifier id) {
-    fprintf(cache, "%" PRIuMAX, id.time);
+    json_serialize_uintmax(cache, id.time);
 }
 
 void serialize_file_symbols(FILE* cache, bld_set* symbols, int depth) {
@@ -218,29 +274,30 @@ void serialize_file_symbols(FILE* cache, bld_set* symbols, int depth) {
     bld_string* symbol;
     bld_iter iter;
 
-    fprintf(cache, "[");
+    fputc('[', cache);
     if (symbols->size > 1) {
-        fprintf(cache, "\n");
+        fputc('\n', cache);
     }
 
     first = 1;
     iter = iter_set(symbols);
     while (iter_next(&iter, (void**) &symbol)) {
         if (!first) {
-            fprintf(cache, ",\n");
+            fputs(",\n", cache);
         } else {
             first = 0;
         }
         if (symbols->size > 1) {
-            fprintf(cache, "%*c", 2 * depth, ' ');
+            json_serialize_indent(cache, 2 * depth);
         }
-        fprintf(cache, "\"%s\"", string_unpack(symbol));
+        json_serialize_string(cache, string_unpack(symbol));
     }
 
     if (symbols->size > 1) {
-        fprintf(cache, "\n%*c", 2 * (depth - 1), ' ');
+        fputc('\n', cache);
+        json_serialize_indent(cache, 2 * (depth - 1));
     }
-    fprintf(cache, "]");
+    fputc(']', cache);
 }
 
 void serialize_file_includes(FILE* cache, bld_set* includes, int depth) {
@@ -248,25 +305,266 @@ void serialize_file_includes(FILE* cache, bld_set* includes, int depth) {
     bld_iter iter;
     bld_path* path;
 
-    fprintf(cache, "[");
+    fputc('[', cache);
     if (includes->size > 0) {
-        fprintf(cache, "\n");
+        fputc('\n', cache);
     }
 
     first = 1;
     iter = iter_set(includes);
     while (iter_next(&iter, (void**) &path)) {
         if (!first) {
-            fprintf(cache, ",\n");
+            fputs(",\n", cache);
         } else {
             first = 0;
         }
-        fprintf(cache, "%*c", 2 * depth, ' ');
-        fprintf(cache, "\"%s\"", path_to_string(path));
+        json_serialize_indent(cache, 2 * depth);
+        json_serialize_string(cache, path_to_string(path));
     }
 
     if (includes->size > 0) {
-        fprintf(cache, "\n%*c", 2 * (depth - 1), ' ');
+        fputc('\n', cache);
+        json_serialize_indent(cache, 2 * (depth - 1));
+    }
+    fputc(']', cache);
+}
+
+void serialize_file_compile_times(FILE* cache, bld_array* times) {
+    int first;
+    bld_iter iter;
+    bld_time* duration;
+
+    fputc('[', cache);
+
+    first = 1;
+    iter = iter_array(times);
+    while (iter_next(&iter, (void**) &duration)) {
+        if (!first) {
+            fputs(", ", cache);
+        } else {
+            first = 0;
+        }
+        json_serialize_uintmax(cache, *duration);
+    }
+
+    fputc(']', cache);
+}
+
+void serialize_builds(FILE* cache, bld_array* builds, int depth) {
+    int first;
+    bld_iter iter;
+    bld_build_stats* stats;
+
+    fputs("[\n", cache);
+
+    first = 1;
+    iter = iter_array(builds);
+    while (iter_next(&iter, (void**) &stats)) {
+        if (!first) {
+            fputs(",\n", cache);
+        } else {
+            first = 0;
+        }
+        json_serialize_indent(cache, 2 * depth);
+        serialize_build(cache, stats);
+    }
+
+    fputc('\n', cache);
+    json_serialize_indent(cache, 2 * (depth - 1));
+    fputc(']', cache);
+}
+
+void serialize_build(FILE* cache, bld_build_stats* stats) {
+    fputs("{\"wall_time\": ", cache);
+    json_serialize_uintmax(cache, stats->wall_time);
+    fputs(", \"cpu_time\": ", cache);
+    json_serialize_uintmax(cache, stats->cpu_time);
+    fputs(", \"link_time\": ", cache);
+    json_serialize_uintmax(cache, stats->link_time);
+    fputs(", \"compiled\": ", cache);
+    json_serialize_uintmax(cache, stats->compiled);
+    fputs(", \"cached\": ", cache);
+    json_serialize_uintmax(cache, stats->cached);
+    fputs(", \"longest_compile\": ", cache);
+    json_serialize_uintmax(cache, stats->longest_compile);
+    fputc('}', cache);
+}
+
+void serialize_link(FILE* cache, bld_project_cache* project_cache) {
+    fputs("{\"fingerprint\": ", cache);
+    json_serialize_uintmax(cache, project_cache->link_fingerprint);
+    fputs(", \"mtime\": ", cache);
+    json_serialize_uintmax(cache, project_cache->link_mtime);
+    fputc('}', cache);
+}
+
+int serialize_journal_possible(bld_project* project) {
+    size_t directories;
+    bld_iter iter;
+    bld_file *file, *cached;
+    bld_project_cache* cache;
+
+    cache = &project->base.cache;
+    if (project->base.rebuilding || !cache->set || !cache->journal) {return 0;}
+    if (linker_hash(&project->base.linker) != linker_hash(&cache->linker)) {return 0;}
+
+    /* The journal only records files, any change to the directory tree is written as a snapshot */
+    directories = 0;
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        if (file->type != BLD_FILE_DIRECTORY) {continue;}
+        directories += 1;
+
+        cached = set_get(&cache->files, file->identifier.id);
+        if (cached == NULL || cached->type != BLD_FILE_DIRECTORY) {return 0;}
+        if (file->parent_id != cached->parent_id) {return 0;}
+        if (file_resolution_get(file, &project->resolutions)->compiler_hash != file_hash_compiler(cached, &cache->files)) {return 0;}
+        if (file_resolution_get(file, &project->resolutions)->linker_hash != file_hash_linker(cached, &cache->files)) {return 0;}
     }
-    fprintf(cache, "]");
+
+    iter = iter_set(&cache->files);
+    while (iter_next(&iter, (void**) &cached)) {
+        if (cached->type != BLD_FILE_DIRECTORY) {continue;}
+        if (directories == 0) {return 0;}
+        directories -= 1;
+    }
+
+    return directories == 0;
+}
+
+int serialize_journal_kept(bld_project* project, bld_file* file) {
+    if (file == NULL || file->type == BLD_FILE_DIRECTORY) {return 0;}
+    if (project->base.rebuilding && file->identifier.id == project->main_file) {return 0;}
+    if ((file->type == BLD_FILE_IMPLEMENTATION || file->type == BLD_FILE_TEST) && !file->compile_successful) {return 0;}
+    return 1;
+}
+
+int serialize_journal_changed(bld_file* file, bld_file* cached) {
+    size_t i;
+    bld_array *times, *cached_times;
+
+    if (cached == NULL || cached->type != file->type) {return 1;}
+    if (cached->identifier.hash != file->identifier.hash) {return 1;}
+    if (cached->identifier.time != file->identifier.time) {return 1;}
+
+    times = file_compile_times_get(file);
+    cached_times = file_compile_times_get(cached);
+    if (times == NULL || cached_times == NULL) {return 0;}
+    if (times->size != cached_times->size) {return 1;}
+
+    for (i = 0; i < times->size; i++) {
+        if (*(bld_time*) array_get(times, i) != *(bld_time*) array_get(cached_times, i)) {return 1;}
+    }
+    return 0;
+}
+
+void serialize_journal(bld_project* project) {
+    FILE* journal;
+    int first, keys;
+    bld_path path;
+    bld_iter iter;
+    bld_array changed, removed;
+    bld_file *file, *cached, **entry;
+    bld_project_cache* cache;
+    int depth = 1;
+
+    cache = &project->base.cache;
+    changed = array_new(sizeof(bld_file*));
+    removed = array_new(sizeof(bld_file*));
+
+    iter = iter_set(&project->files);
+    while (iter_next(&iter, (void**) &file)) {
+        if (!serialize_journal_kept(project, file)) {continue;}
+
+        cached = set_get(&cache->files, file->identifier.id);
+        if (!serialize_journal_changed(file, cached)) {continue;}
+        array_push(&changed, &file);
+    }
+
+    iter = iter_set(&cache->files);
+    while (iter_next(&iter, (void**) &cached)) {
+        if (cached->type == BLD_FILE_DIRECTORY) {continue;}
+        if (serialize_journal_kept(project, set_get(&project->files, cached->identifier.id))) {continue;}
+        array_push(&removed, &cached);
+    }
+
+    /* A no-op build still appends its entry to the history, a record is only skipped when nothing was recorded */
+    if (changed.size == 0 && removed.size == 0 && !cache->link_changed && !cache->build_recorded) {
+        array_free(&changed);
+        array_free(&removed);
+        return;
+    }
+
+    path = path_copy(&project->base.root);
+    path_append_path(&path, &cache->root);
+    path_append_string(&path, BLD_JOURNAL_NAME);
+
+    journal = fopen(path_to_string(&path), "a");
+    if (journal == NULL) {
+        log_fatal("Could not open cache journal for writing under: \"%s\"", path_to_string(&path));
+    }
+
+    fputs("{\n", journal);
+    keys = 0;
+
+    if (changed.size > 0) {
+        json_serialize_key(journal, "files", depth);
+        fputc('[', journal);
+
+        first = 1;
+        iter = iter_array(&changed);
+        while (iter_next(&iter, (void**) &entry)) {
+            fputs(first ? "\n" : ",\n", journal);
+            first = 0;
+
+            /* Passing the file as main serializes its full path instead of its name */
+            json_serialize_indent(journal, 2 * (depth + 1));
+            serialize_file(journal, (*entry)->identifier.id, *entry, &project->files, depth + 2);
+        }
+        fputc('\n', journal);
+        json_serialize_indent(journal, 2 * depth);
+        fputc(']', journal);
+        keys += 1;
+    }
+
+    if (removed.size > 0) {
+        if (keys > 0) {fputs(",\n", journal);}
+        json_serialize_key(journal, "removed", depth);
+        fputc('[', journal);
+
+        first = 1;
+        iter = iter_array(&removed);
+        while (iter_next(&iter, (void**) &entry)) {
+            fputs(first ? "\n" : ",\n", journal);
+            first = 0;
+
+            json_serialize_indent(journal, 2 * (depth + 1));
+            json_serialize_string(journal, path_to_string(&(*entry)->path));
+        }
+        fputc('\n', journal);
+        json_serialize_indent(journal, 2 * depth);
+        fputc(']', journal);
+        keys += 1;
+    }
+
+    if (cache->build_recorded && cache->builds.size > 0) {
+        if (keys > 0) {fputs(",\n", journal);}
+        json_serialize_key(journal, "build", depth);
+        serialize_build(journal, array_get(&cache->builds, cache->builds.size - 1));
+        keys += 1;
+    }
+
+    /* A failed link clears the fingerprint, so it is recorded as well */
+    if (cache->link_changed) {
+        if (keys > 0) {fputs(",\n", journal);}
+        json_serialize_key(journal, "link", depth);
+        serialize_link(journal, cache);
+    }
+
+    fputs("\n}\n", journal);
+
+    fclose(journal);
+    array_free(&changed);
+    array_free(&removed);
+    path_free(&path);
 }
@@ -1,5 +1,6 @@
 #include <string.h>
 #include "logging.h"
+#include "mem.h"
 #include "set.h"
 
 bld_offset  hash_compute_offset(size_t);
@@ -72,14 +73,15 @@ bld_set set_new(size_t value_size) {
     set.offset = NULL;
     set.hash = NULL;
     set.values = NULL;
+    set.key_eq = NULL;
 
     return set;
 }
 
 void set_free(bld_set* set) {
-    free(set->offset);
-    free(set->hash);
-    free(set->values);
+    mem_free(set->offset);
+    mem_free(set->hash);
+    mem_free(set->values);
 }
 
 void set_clear(bld_set* set) {
@@ -96,7 +98,7 @@ void set_swap_value(bld_set* set, size_t target, bld_offset* offset, bld_hash* h
     void* value_ptr;
     void* temp;
 
-    temp = malloc(set->value_size);
+    temp = mem_malloc(set->value_size);
     if (temp == NULL) {log_fatal("Cannot swap values");}
 
     hash_swap_entry(target, set->offset, set->hash, offset, hash);
@@ -105,7 +107,7 @@ void set_swap_value(bld_set* set, size_t target, bld_offset* offset, bld_hash* h
     memcpy(value_ptr, value, set->value_size);
     memcpy(value, temp, set->value_size);
 
-    free(temp);
+    mem_free(temp);
 }
 
 int set_add_value(bld_set* set, size_t target, bld_offset* offset, bld_hash* hash, void* value) {
@@ -137,17 +139,17 @@ int set_set_capacity(bld_set* set, size_t capacity) {
     bld_hash hash;
     void* value;
 
-    value = malloc(set->value_size);
+    value = mem_malloc(set->value_size);
     max_offset = hash_compute_offset(capacity);
     total_capacity = capacity + max_offset;
-    offsets = malloc(total_capacity * sizeof(bld_offset));
-    hashes = malloc(total_capacity * sizeof(bld_hash));
-    values = malloc(total_capacity * set->value_size);
+    offsets = mem_malloc(total_capacity * sizeof(bld_offset));
+    hashes = mem_malloc(total_capacity * sizeof(bld_hash));
+    values = mem_malloc(total_capacity * set->value_size);
     if (offsets == NULL || hashes == NULL || values == NULL || value == NULL) {
-        free(offsets);
-        free(hashes);
-        free(values);
-        free(value);
+        mem_free(offsets);
+        mem_free(hashes);
+        mem_free(values);
+        mem_free(value);
         return -1;
     }
 
@@ -158,6 +160,7 @@ int set_set_capacity(bld_set* set, size_t capacity) {
     new_set.offset = offsets;
     new_set.hash = hashes;
     new_set.values = values;
+    new_set.key_eq = set->key_eq;
 
     for (i = 0; i < new_set.capacity + new_set.max_offset; i++) {
         new_set.offset[i] = new_set.max_offset;
@@ -183,17 +186,17 @@ int set_set_capacity(bld_set* set, size_t capacity) {
     }
 
     if (!error) {
-        free(set->offset);
-        free(set->hash);
-        free(set->values);
+        mem_free(set->offset);
+        mem_free(set->hash);
+        mem_free(set->values);
         *set = new_set;
     } else {
-        free(new_set.offset);
-        free(new_set.hash);
-        free(new_set.values);
+        mem_free(new_set.offset);
+        mem_free(new_set.hash);
+        mem_free(new_set.values);
     }
 
-    free(value);
+    mem_free(value);
     return error;
 }
 
@@ -204,7 +207,7 @@ int set_add(bld_set* set, bld_hash hash, void* value) {
     bld_offset offset;
     void* temp;
 
-    temp = malloc(set->value_size);
+    temp = mem_malloc(set->value_size);
     if (temp == NULL) {log_fatal("Cannot add value");}
     memcpy(temp, value, set->value_size);
 
@@ -215,8 +218,11 @@ int set_add(bld_set* set, bld_hash hash, void* value) {
 
         if (!error && set->offset[target] < set->max_offset) {
             if (set->hash[target] == hash) {
+                if (set->key_eq != NULL && !set->key_eq(((char*) set->values) + target * set->value_size, value)) {
+                    log_fatal("set_add: two different keys have the same hash %" PRIuMAX, hash);
+                }
                 log_warn("Trying to add value twice");
-                free(temp);
+                mem_free(temp);
                 return -1;
             }
         }
@@ -250,7 +256,7 @@ int set_add(bld_set* set, bld_hash hash, void* value) {
         }
     } while (error);
 
-    free(temp);
+    mem_free(temp);
     if (error) {
         log_fatal("Unable to add value to set");
     }
@@ -332,17 +338,48 @@ int set_has(const bld_set* set, bld_hash hash) {
     return 0;
 }
 
+void* set_get_key(const bld_set* set, bld_hash hash, const void* key) {
+    void* value;
+
+    /* The stored key has to match as well, a value under a colliding key is not returned */
+    value = set_get(set, hash);
+    if (value == NULL || set->key_eq == NULL) {return value;}
+    if (!set->key_eq(value, key)) {return NULL;}
+    return value;
+}
+
+int set_has_key(const bld_set* set, bld_hash hash, const void* key) {
+    return set_get_key(set, hash, key) != NULL;
+}
+
 int set_empty_intersection(const bld_set* set1, const bld_set* set2) {
     size_t i;
+    char* value;
+    char* values;
+
+    values = set1->values;
     for (i = 0; i < set1->capacity + set1->max_offset; i++) {
         if (set1->offset[i] >= set1->max_offset) {continue;}
-        if (set_has(set2, set1->hash[i])) {
-            return 0;
+
+        value = set_get(set2, set1->hash[i]);
+        if (value == NULL) {continue;}
+
+        /* Keys are only comparable when both sets verify them the same way */
+        if (set1->key_eq != NULL && set1->key_eq == set2->key_eq
+            && !set1->key_eq(values + i * set1->value_size, value)) {
+            log_warn("set_empty_intersection: two different keys have the same hash %" PRIuMAX, set1->hash[i]);
+            continue;
         }
+        return 0;
     }
     return 1;
 }
 
+void set_verify_keys(bld_set* set, bld_set_key_eq key_eq) {
+    /* Values stored under an existing hash are compared, a mismatch is a collision */
+    set->key_eq = key_eq;
+}
+
 bld_set set_copy(const bld_set* set) {
     bld_set cpy;
     size_t total_capacity;
@@ -351,9 +388,9 @@ bld_set set_copy(const bld_set* set) {
     void* values;
 
     total_capacity = set->capacity + set->max_offset;
-    offsets = malloc(total_capacity * sizeof(bld_offset));
-    hashes = malloc(total_capacity * sizeof(bld_hash));
-    values = malloc(total_capacity * set->value_size);
+    offsets = mem_malloc(total_capacity * sizeof(bld_offset));
+    hashes = mem_malloc(total_capacity * sizeof(bld_hash));
+    values = mem_malloc(total_capacity * set->value_size);
 
     if (offsets == NULL || hashes == NULL || values == NULL) {
         log_fatal("set_copy: Could not allocate space for copy");
@@ -366,6 +403,7 @@ bld_set set_copy(const bld_set* set) {
     cpy.offset = offsets;
     cpy.hash = hashes;
     cpy.values = values;
+    cpy.key_eq = set->key_eq;
 
     memcpy(cpy.offset, set->offset, total_capacity * sizeof(bld_offset));
     memcpy(cpy.hash, set->hash, total_capacity * sizeof(bld_hash));
@@ -5,6 +5,7 @@
 
 typedef uintmax_t bld_hash;
 typedef size_t bld_offset;
+typedef int (*bld_set_key_eq)(const void*, const void*);
 
 typedef struct bld_set {
     size_t capacity;
@@ -14,16 +15,20 @@ typedef struct bld_set {
     bld_offset* offset;
     bld_hash* hash;
     void* values;
+    bld_set_key_eq key_eq;
 } bld_set;
 
 bld_set     set_new(size_t);
 void        set_free(bld_set*);
 bld_set     set_copy(const bld_set*);
+void        set_verify_keys(bld_set*, bld_set_key_eq);
 void        set_clear(bld_set*);
 int         set_add(bld_set*, bld_hash, void*);
 void*       set_remove(bld_set*, bld_hash);
 void*       set_get(const bld_set*, bld_hash);
 int         set_has(const bld_set*, bld_hash);
+void*       set_get_key(const bld_set*, bld_hash, const void*);
+int         set_has_key(const bld_set*, bld_hash, const void*);
 int         set_empty_intersection(const bld_set*, const bld_set*);
 
 #endif
@@ -0,0 +1,47 @@
+#include <assert.h>
+#include "../bitset.h"
+
+void test_bitset_new(void) {
+    size_t i;
+    bld_bitset bitset;
+
+    bitset = bitset_new(100);
+    assert(bitset.size == 100);
+    for (i = 0; i < bitset.size; i++) {
+        assert(!bitset_test(&bitset, i));
+    }
+
+    bitset_free(&bitset);
+}
+
+void test_bitset_set(void) {
+    size_t i;
+    bld_bitset bitset;
+
+    bitset = bitset_new(200);
+    bitset_set(&bitset, 0);
+    bitset_set(&bitset, 63);
+    bitset_set(&bitset, 64);
+    bitset_set(&bitset, 199);
+
+    for (i = 0; i < bitset.size; i++) {
+        assert(bitset_test(&bitset, i) == (i == 0 || i == 63 || i == 64 || i == 199));
+    }
+
+    bitset_free(&bitset);
+}
+
+void test_bitset_empty(void) {
+    bld_bitset bitset;
+
+    bitset = bitset_new(0);
+    assert(bitset.size == 0);
+    bitset_free(&bitset);
+}
+
+int main() {
+    test_bitset_new();
+    test_bitset_set();
+    test_bitset_empty();
+    return 0;
+}
@@ -92,11 +92,57 @@ void test_graph_has_node(void) {
     graph_free(&graph);
 }
 
+void test_graph_index(void) {
+    bld_graph_index index;
+
+    index = graph_index_new();
+    assert(graph_index_add(&index, 1000) == 0);
+    assert(graph_index_add(&index, 7) == 1);
+    assert(graph_index_add(&index, 1000) == 0);
+
+    assert(graph_index_get(&index, 7) == 1);
+    assert(graph_index_get(&index, 8) == BLD_GRAPH_NO_NODE);
+
+    graph_index_free(&index);
+}
+
+void test_graph_csr(void) {
+    bld_graph graph;
+    bld_graph_index index;
+    bld_graph_csr csr;
+
+    graph = graph_new();
+    index = graph_index_new();
+    graph_add_node(&graph, 5);
+    graph_add_node(&graph, 6);
+    graph_add_edge(&graph, 5, 6);
+    graph_add_edge(&graph, 5, 5);
+    graph_index_add(&index, 5);
+    graph_index_add(&index, 6);
+    graph_index_add(&index, 9);
+
+    csr = graph_csr_new(&graph, &index);
+    assert(csr.nodes == 3);
+    assert(csr.ids[0] == 5 && csr.ids[1] == 6 && csr.ids[2] == 9);
+
+    assert(csr.offsets[1] - csr.offsets[0] == 2);
+    assert(csr.targets[csr.offsets[0]] == 1);
+    assert(csr.targets[csr.offsets[0] + 1] == 0);
+    assert(csr.offsets[2] - csr.offsets[1] == 0);
+    assert(csr.offsets[3] - csr.offsets[2] == 0);
+
+    graph_csr_free(&csr);
+    graph_index_free(&index);
+    graph_free(&graph);
+}
+
 int main() {
     test_graph_new();
     test_graph_free();
     test_graph_add_node();
     test_graph_add_edge();
     test_graph_has_node();
+    test_graph_index();
+    test_graph_csr();
     return 0;
 }
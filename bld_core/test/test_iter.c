@@ -68,6 +68,33 @@ void test_iter_set(void) {
     set_free(&set);
 }
 
+void test_iter_set_key(void) {
+    bld_set set;
+    bld_hash hash[] = {10, 21, 32};
+    int number[] = {0, 1, 2};
+
+    set = set_new(sizeof(int));
+    set_add(&set, hash[0], &number[0]);
+    set_add(&set, hash[1], &number[1]);
+    set_add(&set, hash[2], &number[2]);
+
+    {
+        bld_iter iter;
+        int* result;
+        int count;
+
+        count = 0;
+        iter = iter_set(&set);
+        while (iter_next(&iter, (void**) &result)) {
+            assert(iter_set_key(&iter) == hash[*result]);
+            count += 1;
+        }
+        assert(count == 3);
+    }
+
+    set_free(&set);
+}
+
 void test_iter_graph(void) {
     bld_graph graph;
     uintmax_t nodes[] = {0, 1, 2, 3, 4};
@@ -130,6 +157,52 @@ void test_iter_graph(void) {
     graph_free(&graph);
 }
 
+void test_iter_graph_csr(void) {
+    bld_graph graph;
+    bld_graph_index index;
+    bld_graph_csr csr;
+    uintmax_t nodes[] = {10, 11, 12, 13, 14};
+    uintmax_t edges[][2] = {{10, 11}, {10, 12}, {11, 12}, {13, 14}, {14, 13}, {12, 14}};
+
+    graph = graph_new();
+    index = graph_index_new();
+    {
+        unsigned int i;
+
+        for (i = 0; i < ARRAY_SIZE(nodes); i++) {
+            graph_add_node(&graph, nodes[i]);
+            graph_index_add(&index, nodes[i]);
+        }
+
+        for (i = 0; i < ARRAY_SIZE(edges); i++) {
+            graph_add_edge(&graph, edges[i][0], edges[i][1]);
+        }
+    }
+    csr = graph_csr_new(&graph, &index);
+
+    {
+        bld_iter iter, csr_iter;
+        uintmax_t node, csr_node;
+        int count;
+
+        /* The snapshot visits the same nodes in the same order as the graph */
+        count = 0;
+        iter = iter_graph(&graph, 10);
+        csr_iter = iter_graph_csr(&csr, graph_index_get(&index, 10));
+        while (iter_next(&iter, (void**) &node)) {
+            assert(iter_next(&csr_iter, (void**) &csr_node));
+            assert(node == csr_node);
+            count += 1;
+        }
+        assert(!iter_next(&csr_iter, (void**) &csr_node));
+        assert(count == 5);
+    }
+
+    graph_csr_free(&csr);
+    graph_index_free(&index);
+    graph_free(&graph);
+}
+
 void test_iter_graph_children(void) {
     bld_graph graph;
     uintmax_t nodes[] = {0, 1, 2, 3, 4};
@@ -195,7 +268,9 @@ void test_iter_graph_children(void) {
 int main() {
     test_iter_array();
     test_iter_set();
+    test_iter_set_key();
     test_iter_graph();
     test_iter_graph_children();
+    test_iter_graph_csr();
     return 0;
 }
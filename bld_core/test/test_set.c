@@ -15,6 +15,7 @@ void test_set_new(void) {
     assert(set.offset == NULL);
     assert(set.hash == NULL);
     assert(set.values == NULL);
+    assert(set.key_eq == NULL);
 }
 
 void test_set_free(void) {
@@ -224,6 +225,61 @@ void test_set_empty_intersection(void) {
     set_free(&set2);
 }
 
+int test_int_eq(const void* a, const void* b) {
+    return *(const int*) a == *(const int*) b;
+}
+
+void test_set_verify_keys(void) {
+    bld_set set;
+    bld_set copy_set;
+    int number;
+
+    set = set_new(sizeof(int));
+    set_verify_keys(&set, test_int_eq);
+    assert(set.key_eq == test_int_eq);
+
+    number = 3;
+    assert(!set_add(&set, 7, &number));
+    assert(set_add(&set, 7, &number));
+    assert(set.size == 1);
+
+    copy_set = set_copy(&set);
+    assert(copy_set.key_eq == test_int_eq);
+
+    set_free(&set);
+    set_free(&copy_set);
+}
+
+void test_set_get_key(void) {
+    bld_set set1;
+    bld_set set2;
+    int number, other;
+
+    set1 = set_new(sizeof(int));
+    set2 = set_new(sizeof(int));
+    set_verify_keys(&set1, test_int_eq);
+    set_verify_keys(&set2, test_int_eq);
+
+    number = 3;
+    other = 4;
+    set_add(&set1, 7, &number);
+    assert(*(int*) set_get_key(&set1, 7, &number) == 3);
+    assert(set_has_key(&set1, 7, &number));
+    assert(set_get_key(&set1, 7, &other) == NULL);
+    assert(!set_has_key(&set1, 7, &other));
+    assert(!set_has_key(&set1, 8, &number));
+
+    set_add(&set2, 7, &other);
+    assert(set_empty_intersection(&set1, &set2));
+
+    set_remove(&set2, 7);
+    set_add(&set2, 7, &number);
+    assert(!set_empty_intersection(&set1, &set2));
+
+    set_free(&set1);
+    set_free(&set2);
+}
+
 int main() {
     test_set_new();
     test_set_free();
@@ -234,5 +290,7 @@ int main() {
     test_set_remove();
     test_set_has();
     test_set_empty_intersection();
+    test_set_verify_keys();
+    test_set_get_key();
     return 0;
 }
@@ -0,0 +1,91 @@
+#include "os.h"
+#include "logging.h"
+#include "trace.h"
+
+void trace_write_string(FILE*, char*);
+
+bld_trace trace_state = {0, 0, 0, NULL, NULL};
+
+int trace_start(char* path) {
+    if (trace_state.enabled) {
+        log_warn("Trace already started, ignoring \"%s\"", path);
+        return -1;
+    }
+
+    trace_state.file = fopen(path, "w");
+    if (trace_state.file == NULL) {
+        log_warn("Could not open trace file \"%s\" for writing", path);
+        return -1;
+    }
+
+    trace_state.enabled = 1;
+    trace_state.events = 0;
+    trace_state.lock = os_mutex_new();
+    trace_state.start = os_time_monotonic();
+
+    fprintf(trace_state.file, "{\"traceEvents\":[");
+    return 0;
+}
+
+void trace_stop(void) {
+    if (!trace_state.enabled) {return;}
+
+    fprintf(trace_state.file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(trace_state.file);
+    os_mutex_free(trace_state.lock);
+
+    trace_state.enabled = 0;
+    trace_state.file = NULL;
+    trace_state.lock = NULL;
+}
+
+uintmax_t trace_begin(void) {
+    if (!trace_state.enabled) {return 0;}
+    return os_time_monotonic();
+}
+
+void trace_end(uintmax_t begin, char* category, char* name, char* file, int slot) {
+    uintmax_t end;
+    FILE* out;
+
+    if (!trace_state.enabled) {return;}
+
+    end = os_time_monotonic();
+    out = trace_state.file;
+
+    /* Events can be emitted from worker threads */
+    os_mutex_lock(trace_state.lock);
+    if (trace_state.events > 0) {
+        fprintf(out, ",");
+    }
+    trace_state.events += 1;
+
+    fprintf(out, "\n{\"name\":");
+    trace_write_string(out, name);
+    fprintf(out, ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d", category, slot);
+    fprintf(out, ",\"ts\":%" PRIuMAX ".%03" PRIuMAX, (begin - trace_state.start) / 1000, (begin - trace_state.start) % 1000);
+    fprintf(out, ",\"dur\":%" PRIuMAX ".%03" PRIuMAX, (end - begin) / 1000, (end - begin) % 1000);
+
+    if (file != NULL) {
+        fprintf(out, ",\"args\":{\"file\":");
+        trace_write_string(out, file);
+        fprintf(out, ",\"slot\":%d}", slot);
+    }
+    fprintf(out, "}");
+    os_mutex_unlock(trace_state.lock);
+}
+
+void trace_write_string(FILE* out, char* str) {
+    putc('\"', out);
+    for (; *str != '\0'; str++) {
+        if (*str == '\"' || *str == '\\') {
+            putc('\\', out);
+            putc(*str, out);
+        } else if ((unsigned char) *str < 0x20) {
+            fprintf(out, "\\u%04x", (unsigned char) *str);
+        } else {
+            putc(*str, out);
+        }
+    }
+    putc('\"', out);
+}
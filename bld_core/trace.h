@@ -0,0 +1,26 @@
+#ifndef TRACE_H
+#define TRACE_H
+#include <stdio.h>
+#include <inttypes.h>
+#include "os.h"
+
+#define BLD_TRACE_PHASE "phase"
+#define BLD_TRACE_JOB "job"
+
+typedef struct bld_trace {
+    int enabled;
+    int events;
+    uintmax_t start;
+    FILE* file;
+    bld_os_mutex* lock;
+} bld_trace;
+
+extern bld_trace trace_state;
+
+int         trace_start(char*);
+void        trace_stop(void);
+
+uintmax_t   trace_begin(void);
+void        trace_end(uintmax_t, char*, char*, char*, int);
+
+#endif
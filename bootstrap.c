@@ -19,11 +19,13 @@ int main(int argc, char** argv) {
 
     linker = linker_new(BLD_LINKER_CLANG, "clang");
     linker_add_flag(&linker, "-fsanitize=address");
+    linker_add_flag(&linker, "-pthread");
 
     fproject = project_new(project_path_extract(argc, argv), compiler, linker);
 
     project_add_build(&fproject, "bld_core");
     project_ignore_path(&fproject, "bld_core/test");
+    project_ignore_path(&fproject, "bld_core/bench");
     rebuild_builder(&fproject, argc, argv);
 
     project_load_cache(&fproject, ".build_cache");
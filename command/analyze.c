@@ -0,0 +1,382 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../bld_core/iter.h"
+#include "../bld_core/logging.h"
+#include "../bld_core/json.h"
+#include "../bld_core/incremental.h"
+#include "init.h"
+#include "build.h"
+#include "analyze.h"
+
+const bld_string bld_command_string_analyze = STRING_COMPILE_TIME_PACK("analyze");
+const bld_string bld_command_string_analyze_flag_top = STRING_COMPILE_TIME_PACK("top");
+const bld_string bld_command_string_analyze_flag_dot = STRING_COMPILE_TIME_PACK("dot");
+const bld_string bld_command_string_analyze_flag_json = STRING_COMPILE_TIME_PACK("json");
+
+typedef struct bld_analyze_entry {
+    bld_file* header;
+    size_t units;
+    bld_time cost;
+} bld_analyze_entry;
+
+int command_analyze_entry_compare(const void*, const void*);
+bld_analyze_entry command_analyze_header(bld_project*, bld_file*);
+bld_file* command_analyze_node_file(bld_project*, bld_graph_csr*, bld_node);
+int command_analyze_dot(bld_project*, bld_string*, char*);
+int command_analyze_json(bld_project*, bld_string*, bld_array*, char*);
+void command_analyze_json_edges(FILE*, bld_graph_csr*, int);
+int command_analyze_flag_path(bld_command*, const bld_string*, int*, bld_string*);
+
+int command_analyze(bld_command_analyze* cmd, bld_data* data) {
+    int error;
+    size_t i;
+    bld_iter iter;
+    bld_file* file;
+    bld_array entries;
+    bld_forward_project fproject;
+    bld_project project;
+
+    set_log_level(data->config.log_level);
+
+    os_stat_cache_start();
+    fproject = command_build_project_new(&cmd->target, NULL, data);
+    project = project_resolve(&fproject);
+
+    /* Nothing is compiled, symbols are only known for files compiled by an earlier build */
+    dependency_graph_extract_includes(&project.graph, &project.base, project.main_file, &project.files);
+    dependency_graph_extract_symbols(&project.graph, &project.base, project.main_file, &project.files);
+    os_stat_cache_stop();
+
+    entries = array_new(sizeof(bld_analyze_entry));
+    iter = iter_set(&project.files);
+    while (iter_next(&iter, (void**) &file)) {
+        bld_analyze_entry entry;
+
+        if (file->type != BLD_FILE_INTERFACE) {continue;}
+
+        entry = command_analyze_header(&project, file);
+        array_push(&entries, &entry);
+    }
+    qsort(entries.values, entries.size, entries.value_size, command_analyze_entry_compare);
+
+    printf("Target: %s\n", string_unpack(&cmd->target));
+    if (!project.base.cache.set) {
+        printf("No compile times recorded, build the target with `bld %s` first\n", string_unpack(&cmd->target));
+    }
+
+    printf("\nHeaders by rebuild cost (compile time of the translation units including them):\n");
+    if (entries.size == 0) {
+        printf("  No headers found\n");
+    }
+    for (i = 0; i < entries.size && i < (size_t) cmd->top; i++) {
+        bld_analyze_entry* entry;
+
+        entry = array_get(&entries, i);
+        printf("  %8" PRIuMAX ".%01" PRIuMAX " ms", entry->cost / 1000, (entry->cost % 1000) / 100);
+        printf(" %5lu unit(s)  %s\n", (unsigned long) entry->units, path_to_string(&entry->header->path));
+    }
+
+    error = 0;
+    if (cmd->dot) {
+        error |= command_analyze_dot(&project, &cmd->target, string_unpack(&cmd->dot_path));
+    }
+    if (cmd->json) {
+        error |= command_analyze_json(&project, &cmd->target, &entries, string_unpack(&cmd->json_path));
+    }
+
+    array_free(&entries);
+    project_free(&project);
+    return error;
+}
+
+bld_analyze_entry command_analyze_header(bld_project* project, bld_file* header) {
+    bld_iter iter;
+    bld_file* file;
+    bld_analyze_entry entry;
+
+    entry.header = header;
+    entry.units = 0;
+    entry.cost = 0;
+
+    /* Edges of the include graph point from a file to the files including it */
+    iter = dependency_graph_includes_from(&project->graph, header);
+    while (dependency_graph_next_file(&iter, &project->files, &file)) {
+        bld_array* times;
+
+        if (file->type != BLD_FILE_IMPLEMENTATION && file->type != BLD_FILE_TEST) {continue;}
+        entry.units += 1;
+
+        times = file_compile_times_get(file);
+        if (times->size == 0) {continue;}
+        entry.cost += *(bld_time*) array_get(times, times->size - 1);
+    }
+
+    return entry;
+}
+
+int command_analyze_entry_compare(const void* a, const void* b) {
+    const bld_analyze_entry* e1 = a;
+    const bld_analyze_entry* e2 = b;
+
+    if (e1->cost != e2->cost) {
+        return e1->cost < e2->cost ? 1 : -1;
+    }
+    if (e1->units != e2->units) {
+        return e1->units < e2->units ? 1 : -1;
+    }
+    return strcmp(path_to_string(&e1->header->path), path_to_string(&e2->header->path));
+}
+
+bld_file* command_analyze_node_file(bld_project* project, bld_graph_csr* csr, bld_node node) {
+    bld_file* file;
+
+    file = set_get(&project->files, csr->ids[node]);
+    if (file == NULL) {log_fatal(LOG_FATAL_PREFIX "file id in graph did not exist in file set.");}
+    return file;
+}
+
+int command_analyze_dot(bld_project* project, bld_string* target, char* path) {
+    bld_node node, edge;
+    bld_graph_csr *includes, *symbols;
+    FILE* out;
+
+    out = fopen(path, "w");
+    if (out == NULL) {
+        log_error("Could not open \"%s\" for writing", path);
+        return -1;
+    }
+
+    includes = &project->graph.include_csr;
+    symbols = &project->graph.symbol_csr;
+
+    /* Solid edges point from a file to the files it includes, dashed edges to the files defining its symbols */
+    fprintf(out, "digraph ");
+    json_serialize_string(out, string_unpack(target));
+    fprintf(out, " {\n    node [shape=box];\n");
+    for (node = 0; node < includes->nodes; node++) {
+        fprintf(out, "    ");
+        json_serialize_string(out, path_to_string(&command_analyze_node_file(project, includes, node)->path));
+        fprintf(out, ";\n");
+    }
+
+    for (node = 0; node < includes->nodes; node++) {
+        for (edge = includes->offsets[node]; edge < includes->offsets[node + 1]; edge++) {
+            if (includes->targets[edge] == node) {continue;}
+            fprintf(out, "    ");
+            json_serialize_string(out, path_to_string(&command_analyze_node_file(project, includes, includes->targets[edge])->path));
+            fprintf(out, " -> ");
+            json_serialize_string(out, path_to_string(&command_analyze_node_file(project, includes, node)->path));
+            fprintf(out, ";\n");
+        }
+    }
+
+    for (node = 0; node < symbols->nodes; node++) {
+        for (edge = symbols->offsets[node]; edge < symbols->offsets[node + 1]; edge++) {
+            if (symbols->targets[edge] == node) {continue;}
+            fprintf(out, "    ");
+            json_serialize_string(out, path_to_string(&command_analyze_node_file(project, symbols, node)->path));
+            fprintf(out, " -> ");
+            json_serialize_string(out, path_to_string(&command_analyze_node_file(project, symbols, symbols->targets[edge])->path));
+            fprintf(out, " [style=dashed];\n");
+        }
+    }
+
+    fprintf(out, "}\n");
+    fclose(out);
+    return 0;
+}
+
+int command_analyze_json(bld_project* project, bld_string* target, bld_array* entries, char* path) {
+    bld_node node;
+    bld_iter iter;
+    bld_analyze_entry* entry;
+    bld_graph_csr* includes;
+    FILE* out;
+
+    out = json_create(path);
+    if (out == NULL) {
+        log_error("Could not open \"%s\" for writing", path);
+        return -1;
+    }
+
+    includes = &project->graph.include_csr;
+
+    fputs("{\n", out);
+    json_serialize_key(out, "target", 1);
+    json_serialize_string(out, string_unpack(target));
+
+    /* Edges refer to files by their position in "files" */
+    fputs(",\n", out);
+    json_serialize_key(out, "files", 1);
+    fputs("[", out);
+    for (node = 0; node < includes->nodes; node++) {
+        bld_file* file;
+
+        file = command_analyze_node_file(project, includes, node);
+        fputs(node > 0 ? ",\n" : "\n", out);
+        json_serialize_indent(out, 4);
+        fputs("{\"path\": ", out);
+        json_serialize_string(out, path_to_string(&file->path));
+        fputs(", \"type\": ", out);
+        json_serialize_string(out, file->type == BLD_FILE_INTERFACE ? "interface" : file->type == BLD_FILE_TEST ? "test" : "implementation");
+        fputs("}", out);
+    }
+    fputs("\n  ]", out);
+
+    fputs(",\n", out);
+    json_serialize_key(out, "includes", 1);
+    command_analyze_json_edges(out, includes, 1);
+
+    fputs(",\n", out);
+    json_serialize_key(out, "symbols", 1);
+    command_analyze_json_edges(out, &project->graph.symbol_csr, 0);
+
+    fputs(",\n", out);
+    json_serialize_key(out, "headers", 1);
+    fputs("[", out);
+    iter = iter_array(entries);
+    while (iter_next(&iter, (void**) &entry)) {
+        fputs(entry == entries->values ? "\n" : ",\n", out);
+        json_serialize_indent(out, 4);
+        fputs("{\"path\": ", out);
+        json_serialize_string(out, path_to_string(&entry->header->path));
+        fputs(", \"units\": ", out);
+        json_serialize_uintmax(out, entry->units);
+        fputs(", \"cost_us\": ", out);
+        json_serialize_uintmax(out, entry->cost);
+        fputs("}", out);
+    }
+    fputs("\n  ]\n}\n", out);
+
+    fclose(out);
+    return 0;
+}
+
+void command_analyze_json_edges(FILE* out, bld_graph_csr* csr, int reversed) {
+    int first;
+    bld_node node, edge;
+
+    first = 1;
+    fputs("[", out);
+    for (node = 0; node < csr->nodes; node++) {
+        for (edge = csr->offsets[node]; edge < csr->offsets[node + 1]; edge++) {
+            if (csr->targets[edge] == node) {continue;}
+            fputs(first ? "\n" : ",\n", out);
+            json_serialize_indent(out, 4);
+            fputs("[", out);
+            json_serialize_uintmax(out, reversed ? csr->targets[edge] : node);
+            fputs(", ", out);
+            json_serialize_uintmax(out, reversed ? node : csr->targets[edge]);
+            fputs("]", out);
+            first = 0;
+        }
+    }
+    fputs("\n  ]", out);
+}
+
+int command_analyze_flag_path(bld_command* pre_cmd, const bld_string* name, int* set, bld_string* path) {
+    bld_command_flag* flag;
+
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(name)));
+    *set = flag != NULL;
+    if (*set) {
+        *path = string_copy(&flag->value);
+    }
+    return *set;
+}
+
+int command_analyze_convert(bld_command* pre_cmd, bld_data* data, bld_command_analyze* cmd, bld_command_invalid* invalid) {
+    int error;
+    bld_string err;
+    bld_command_positional* arg;
+    bld_command_positional_optional* target;
+    bld_command_flag* flag;
+
+    if (!data->has_root) {
+        error = -1;
+        err = string_copy(&bld_command_init_missing_project);
+        goto parse_failed;
+    }
+
+    if (data->targets.size == 0) {
+        error = -1;
+        err = string_copy(&bld_command_init_no_targets);
+        goto parse_failed;
+    }
+
+    arg = array_get(&pre_cmd->positional, 0);
+    if (arg->type != BLD_HANDLE_POSITIONAL_OPTIONAL) {log_fatal(LOG_FATAL_PREFIX "missing first optional");}
+    target = &arg->as.opt;
+
+    if (!utils_get_target(&cmd->target, &err, target, data)) {
+        error = -1;
+        goto parse_failed;
+    }
+
+    cmd->top = BLD_COMMAND_ANALYZE_TOP;
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_analyze_flag_top)));
+    if (flag != NULL) {
+        char* end;
+
+        cmd->top = strtol(string_unpack(&flag->value), &end, 10);
+        if (*end != '\0' || end == string_unpack(&flag->value) || cmd->top < 1) {
+            error = -1;
+            err = string_new();
+            string_append_string(&err, "number of headers must be a positive integer, got \"");
+            string_append_string(&err, string_unpack(&flag->value));
+            string_append_string(&err, "\"\n");
+            string_free(&cmd->target);
+            goto parse_failed;
+        }
+    }
+
+    command_analyze_flag_path(pre_cmd, &bld_command_string_analyze_flag_dot, &cmd->dot, &cmd->dot_path);
+    command_analyze_flag_path(pre_cmd, &bld_command_string_analyze_flag_json, &cmd->json, &cmd->json_path);
+
+    return 0;
+    parse_failed:
+    *invalid = command_invalid_new(error, &err);
+    return -1;
+}
+
+bld_handle_annotated command_handle_analyze(char* name) {
+    bld_handle_annotated handle;
+
+    handle.type = BLD_COMMAND_ANALYZE;
+    handle.name = bld_command_string_analyze;
+    handle.handle = handle_new(name);
+    handle_positional_optional(&handle.handle, "The target to analyze");
+    handle_positional_expect(&handle.handle, string_unpack(&bld_command_string_analyze));
+    handle_allow_flags(&handle.handle);
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_analyze_flag_top), "Number of headers to report, default 10");
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_analyze_flag_dot), "Write the include and symbol graphs in DOT format to the given path");
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_analyze_flag_json), "Write the include and symbol graphs and the header costs as JSON to the given path");
+    handle_set_description(
+        &handle.handle,
+        "Reports the headers of a target which are the most expensive to touch.\n"
+        "The rebuild cost of a header is the recorded compile time of every\n"
+        "translation unit which includes it, directly or through other headers,\n"
+        "i.e. the number of such units times their compile time.\n"
+        "\n"
+        "Nothing is compiled and the cache is not touched, compile times and\n"
+        "symbols are only known for files compiled by an earlier build.\n"
+        "\n"
+        "The include and symbol graphs can be exported with --dot and --json."
+    );
+
+    handle.convert = (bld_command_convert*) command_analyze_convert;
+    handle.execute = (bld_command_execute*) command_analyze;
+    handle.free = (bld_command_free*) command_analyze_free;
+
+    return handle;
+}
+
+void command_analyze_free(bld_command_analyze* cmd) {
+    string_free(&cmd->target);
+    if (cmd->dot) {
+        string_free(&cmd->dot_path);
+    }
+    if (cmd->json) {
+        string_free(&cmd->json_path);
+    }
+}
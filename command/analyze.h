@@ -0,0 +1,26 @@
+#ifndef COMMAND_ANALYZE_H
+#define COMMAND_ANALYZE_H
+#include "../bld_core/dstr.h"
+#include "../bld_core/args.h"
+#include "handle.h"
+#include "invalid.h"
+
+#define BLD_COMMAND_ANALYZE_TOP (10)
+
+extern const bld_string bld_command_string_analyze;
+
+typedef struct bld_command_analyze {
+    bld_string target;
+    int top;
+    int dot;
+    bld_string dot_path;
+    int json;
+    bld_string json_path;
+} bld_command_analyze;
+
+bld_handle_annotated command_handle_analyze(char*);
+int command_analyze_convert(bld_command*, bld_data*, bld_command_analyze*, bld_command_invalid*);
+int command_analyze(bld_command_analyze*, bld_data*);
+void command_analyze_free(bld_command_analyze*);
+
+#endif
@@ -1,14 +1,22 @@
+#include <stdlib.h>
 #include "../bld_core/os.h"
 #include "../bld_core/logging.h"
+#include "../bld_core/trace.h"
+#include "../bld_core/mem.h"
 #include "../bld_core/incremental.h"
 #include "init.h"
 #include "build.h"
 
 bld_string bld_command_string_build = STRING_COMPILE_TIME_PACK("build");
+bld_string bld_command_string_build_flag_trace = STRING_COMPILE_TIME_PACK("trace");
+bld_string bld_command_string_build_flag_jobs = STRING_COMPILE_TIME_PACK("jobs");
+bld_string bld_command_string_build_flag_mem_stats = STRING_COMPILE_TIME_PACK("mem-stats");
+bld_string bld_command_string_build_flag_profile = STRING_COMPILE_TIME_PACK("profile");
 
 int command_build_verify_config(bld_string*, bld_data*);
 void command_build_apply_config(bld_forward_project* , bld_data*);
 void command_build_apply_build_info(bld_forward_project*, bld_path*, bld_target_build_information*);
+void command_build_apply_profile(bld_compiler*, bld_linker*, bld_config_profile*);
 
 int command_build(bld_command_build* cmd, bld_data* data) {
     int result;
@@ -18,7 +26,18 @@ int command_build(bld_command_build* cmd, bld_data* data) {
 
     set_log_level(data->config.log_level);
 
-    fproject = command_build_project_new(&cmd->target, data);
+    if (cmd->trace && trace_start(string_unpack(&cmd->trace_path))) {
+        log_fatal("Could not start trace \"%s\"", string_unpack(&cmd->trace_path));
+    }
+    if (cmd->mem_stats) {
+        mem_start();
+    }
+
+    os_stat_cache_start();
+    fproject = command_build_project_new(&cmd->target, cmd->profile ? &cmd->profile_name : NULL, data);
+    if (cmd->jobs > 0) {
+        fproject.base.jobs = cmd->jobs;
+    }
     project = project_resolve(&fproject);
 
     name_executable = string_copy(&cmd->target);
@@ -26,9 +45,12 @@ int command_build(bld_command_build* cmd, bld_data* data) {
     result = incremental_compile_executable(&project, string_unpack(&name_executable));
 
     project_save_cache(&project);
+    os_stat_cache_stop();
+    trace_stop();
 
     string_free(&name_executable);
     project_free(&project);
+    mem_stop();
 
     if (result < 0) {result = 0;}
     return result;
@@ -40,6 +62,7 @@ int command_build_convert(bld_command* pre_cmd, bld_data* data, bld_command_buil
     bld_string err;
     bld_command_positional* arg;
     bld_command_positional_optional* opt;
+    bld_command_flag* flag;
 
     if (!data->has_root) {
         error = -1;
@@ -62,17 +85,64 @@ int command_build_convert(bld_command* pre_cmd, bld_data* data, bld_command_buil
         goto parse_failed;
     }
 
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_trace)));
+    cmd->trace = flag != NULL;
+    if (cmd->trace) {
+        cmd->trace_path = string_copy(&flag->value);
+    }
+
+    cmd->mem_stats = set_has(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_mem_stats)));
+
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_profile)));
+    cmd->profile = flag != NULL;
+    if (cmd->profile) {
+        cmd->profile_name = string_copy(&flag->value);
+    }
+
+    if (command_build_parse_jobs(pre_cmd, &cmd->jobs, &err)) {
+        error = -1;
+        string_free(&cmd->target);
+        if (cmd->trace) {
+            string_free(&cmd->trace_path);
+        }
+        if (cmd->profile) {
+            string_free(&cmd->profile_name);
+        }
+        goto parse_failed;
+    }
+
     return 0;
     parse_failed:
     *invalid = command_invalid_new(error, &err);
     return -1;
 }
 
-bld_forward_project command_build_project_new(bld_string* target, bld_data* data) {
+int command_build_parse_jobs(bld_command* pre_cmd, int* jobs, bld_string* err) {
+    char* end;
+    bld_command_flag* flag;
+
+    *jobs = 0;
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_jobs)));
+    if (flag == NULL) {return 0;}
+
+    *jobs = strtol(string_unpack(&flag->value), &end, 10);
+    if (*end != '\0' || end == string_unpack(&flag->value) || *jobs < 1) {
+        *err = string_new();
+        string_append_string(err, "number of jobs must be a positive integer, got \"");
+        string_append_string(err, string_unpack(&flag->value));
+        string_append_string(err, "\"\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+bld_forward_project command_build_project_new(bld_string* target, bld_string* profile_name, bld_data* data) {
     bld_path path_cache;
     bld_path path_root;
     bld_compiler temp_c;
     bld_linker temp_l;
+    bld_config_profile* profile;
     bld_forward_project fproject;
 
     if (!data->config_parsed) {
@@ -90,6 +160,17 @@ bld_forward_project command_build_project_new(bld_string* target, bld_data* data
         exit(-1);
     }
 
+    profile = NULL;
+    if (profile_name != NULL) {
+        if (!config_profile_name_valid(profile_name)) {
+            log_fatal("Invalid profile name '%s'", string_unpack(profile_name));
+        }
+        profile = config_target_get_profile(&data->target_config, profile_name);
+        if (profile == NULL) {
+            log_fatal("Target '%s' has no profile '%s'", string_unpack(target), string_unpack(profile_name));
+        }
+    }
+
     log_debug("Building target: \"%s\"", string_unpack(target));
     temp_c = compiler_copy(&data->target_config.files.info.compiler.as.compiler);
     temp_l = linker_copy(&data->target_config.linker);
@@ -100,6 +181,10 @@ bld_forward_project command_build_project_new(bld_string* target, bld_data* data
         linker_flags_free(&temp_l.flags);
         temp_l.flags = linker_flags_copy(&data->target_config.files.info.linker_flags);
     }
+    if (profile != NULL) {
+        log_debug("Profile: \"%s\"", string_unpack(&profile->name));
+        command_build_apply_profile(&temp_c, &temp_l, profile);
+    }
 
     path_root = path_copy(&data->root);
     fproject = project_forward_new(&path_root, &temp_c, &temp_l);
@@ -107,7 +192,20 @@ bld_forward_project command_build_project_new(bld_string* target, bld_data* data
     path_cache = path_from_string(".bld");
     path_append_string(&path_cache, "target");
     path_append_string(&path_cache, string_unpack(target));
-    path_append_string(&path_cache, "cache");
+    if (profile == NULL) {
+        path_append_string(&path_cache, "cache");
+    } else {
+        bld_path path_profiles;
+
+        /* Every profile keeps its own objects, switching between them does not recompile */
+        path_append_string(&path_cache, "profiles");
+        path_profiles = path_copy(&data->root);
+        path_append_path(&path_profiles, &path_cache);
+        os_dir_make(path_to_string(&path_profiles));
+        path_free(&path_profiles);
+
+        path_append_string(&path_cache, string_unpack(&profile->name));
+    }
     log_debug("Path to cache: \"%s\"", path_to_string(&path_cache));
     project_load_cache(&fproject, path_to_string(&path_cache));
 
@@ -126,7 +224,12 @@ bld_handle_annotated command_handle_build(char* name) {
     bld_handle_annotated handle;
 
     handle.handle = handle_new(name);
+    handle_allow_flags(&handle.handle);
     handle_positional_optional(&handle.handle, "The target to build");
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_build_flag_trace), "Write a Chrome trace-event file of the build phases and compile jobs to the given path");
+    handle_flag_value(&handle.handle, 'j', string_unpack(&bld_command_string_build_flag_jobs), "Maximum number of files compiled in parallel, defaults to the number of processors");
+    handle_flag(&handle.handle, ' ', string_unpack(&bld_command_string_build_flag_mem_stats), "Report allocations, bytes and peak memory of each build phase");
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_build_flag_profile), "Build with the flags of a profile of the target, see `bld help profile`");
 
     temp = string_new();
     string_append_string(
@@ -148,6 +251,13 @@ bld_handle_annotated command_handle_build(char* name) {
         "do not need to be explicitly stated and are assumed to possibly change at\n"
         "at any point."
     );
+    string_append_string(
+        &temp,
+        "\n\n"
+        "Several targets can be built at once with `bld build <targets...>` or\n"
+        "`bld build --all`, the project is then indexed once and the files of all\n"
+        "targets are compiled by one shared pool of jobs."
+    );
 
     handle_set_description(&handle.handle, string_unpack(&temp));
 
@@ -163,6 +273,12 @@ bld_handle_annotated command_handle_build(char* name) {
 
 void command_build_free(bld_command_build* build) {
     string_free(&build->target);
+    if (build->trace) {
+        string_free(&build->trace_path);
+    }
+    if (build->profile) {
+        string_free(&build->profile_name);
+    }
 }
 
 void command_build_apply_config(bld_forward_project* fproject, bld_data* data) {
@@ -228,6 +344,40 @@ void command_build_apply_build_info(bld_forward_project* fproject, bld_path* pat
     path_free(&sub_path);
 }
 
+void command_build_apply_profile(bld_compiler* compiler, bld_linker* linker, bld_config_profile* profile) {
+    bld_iter iter;
+    bld_string* flag;
+    bld_compiler_flags flags;
+
+    /* Removed flags are dropped from the root compiler, added flags come after its own */
+    flags = compiler_flags_new();
+    iter = iter_array(&compiler->flags.flags);
+    while (iter_next(&iter, (void**) &flag)) {
+        if (set_has_key(&profile->compiler_flags.removed, string_hash(string_unpack(flag)), flag)) {continue;}
+        compiler_flags_add_flag(&flags, string_unpack(flag));
+    }
+
+    iter = iter_array(&profile->compiler_flags.flags);
+    while (iter_next(&iter, (void**) &flag)) {
+        if (set_has_key(&flags.flag_hash, string_hash(string_unpack(flag)), flag)) {continue;}
+        compiler_flags_add_flag(&flags, string_unpack(flag));
+    }
+
+    iter = iter_set(&compiler->flags.removed);
+    while (iter_next(&iter, (void**) &flag)) {
+        if (set_has_key(&flags.flag_hash, string_hash(string_unpack(flag)), flag)) {continue;}
+        compiler_flags_remove_flag(&flags, string_unpack(flag));
+    }
+
+    compiler_flags_free(&compiler->flags);
+    compiler->flags = flags;
+
+    iter = iter_array(&profile->linker_flags.flags);
+    while (iter_next(&iter, (void**) &flag)) {
+        linker_flags_add_flag(&linker->flags, string_unpack(flag));
+    }
+}
+
 int command_build_verify_config(bld_string* target, bld_data* data) {
     int error;
     bld_iter iter;
@@ -5,8 +5,19 @@
 #include "../bld_core/project.h"
 #include "invalid.h"
 
+extern bld_string bld_command_string_build_flag_trace;
+extern bld_string bld_command_string_build_flag_jobs;
+extern bld_string bld_command_string_build_flag_mem_stats;
+extern bld_string bld_command_string_build_flag_profile;
+
 typedef struct bld_command_build {
     bld_string target;
+    int trace;
+    bld_string trace_path;
+    int jobs;
+    int mem_stats;
+    int profile;
+    bld_string profile_name;
 } bld_command_build;
 
 bld_handle_annotated command_handle_build(char*);
@@ -14,6 +25,7 @@ int command_build_convert(bld_command* ,bld_data*, bld_command_build*, bld_comma
 int command_build(bld_command_build*, bld_data*);
 void command_build_free(bld_command_build*);
 
-bld_forward_project command_build_project_new(bld_string*, bld_data*);
+bld_forward_project command_build_project_new(bld_string*, bld_string*, bld_data*);
+int command_build_parse_jobs(bld_command*, int*, bld_string*);
 
 #endif
@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../bld_core/os.h"
+#include "../bld_core/iter.h"
+#include "../bld_core/logging.h"
+#include "../bld_core/trace.h"
+#include "../bld_core/mem.h"
+#include "../bld_core/index.h"
+#include "../bld_core/incremental.h"
+#include "init.h"
+#include "build.h"
+#include "build_targets.h"
+
+const bld_string bld_command_string_build_targets = STRING_COMPILE_TIME_PACK("build");
+const bld_string bld_command_string_build_targets_flag_all = STRING_COMPILE_TIME_PACK("all");
+
+int command_build_targets_compare(const void*, const void*);
+
+int command_build_targets(bld_command_build_targets* cmd, bld_data* data) {
+    int result;
+    bld_iter iter;
+    bld_string* target;
+    bld_array projects, names;
+    bld_project* project;
+
+    set_log_level(data->config.log_level);
+
+    if (cmd->trace && trace_start(string_unpack(&cmd->trace_path))) {
+        log_fatal("Could not start trace \"%s\"", string_unpack(&cmd->trace_path));
+    }
+    if (cmd->mem_stats) {
+        mem_start();
+    }
+
+    /* Targets share directory listings, file identifiers and include scans */
+    index_start();
+    os_stat_cache_start();
+
+    projects = array_new(sizeof(bld_project));
+    names = array_new(sizeof(bld_string));
+    iter = iter_array(&cmd->targets);
+    while (iter_next(&iter, (void**) &target)) {
+        bld_forward_project fproject;
+        bld_project project;
+        bld_string name_executable;
+
+        if (data->target_config_parsed) {
+            config_target_free(&data->target_config);
+            data->target_config_parsed = 0;
+        }
+
+        fproject = command_build_project_new(target, cmd->profile ? &cmd->profile_name : NULL, data);
+        if (cmd->jobs > 0) {
+            fproject.base.jobs = cmd->jobs;
+        }
+        project = project_resolve(&fproject);
+        array_push(&projects, &project);
+
+        name_executable = string_copy(target);
+        string_append_string(&name_executable, "." BLD_EXECUTABLE_FILE_ENDING);
+        array_push(&names, &name_executable);
+    }
+
+    result = incremental_compile_executables(&projects, &names);
+
+    iter = iter_array(&projects);
+    while (iter_next(&iter, (void**) &project)) {
+        project_save_cache(project);
+        project_free(project);
+    }
+
+    iter = iter_array(&names);
+    while (iter_next(&iter, (void**) &target)) {
+        string_free(target);
+    }
+
+    array_free(&projects);
+    array_free(&names);
+    os_stat_cache_stop();
+    index_stop();
+    mem_stop();
+    trace_stop();
+
+    return result;
+}
+
+int command_build_targets_compare(const void* a, const void* b) {
+    const bld_string* s1 = a;
+    const bld_string* s2 = b;
+
+    return strcmp(s1->chars, s2->chars);
+}
+
+int command_build_targets_convert(bld_command* pre_cmd, bld_data* data, bld_command_build_targets* cmd, bld_command_invalid* invalid) {
+    int error, all;
+    size_t i;
+    bld_iter iter;
+    bld_string err;
+    bld_string* target;
+    bld_command_positional* arg;
+    bld_command_positional_vargs* varg;
+    bld_command_flag* flag;
+
+    if (!data->has_root) {
+        error = -1;
+        err = string_copy(&bld_command_init_missing_project);
+        goto parse_failed;
+    }
+
+    if (data->targets.size == 0) {
+        error = -1;
+        err = string_copy(&bld_command_init_no_targets);
+        goto parse_failed;
+    }
+
+    arg = array_get(&pre_cmd->positional, 1);
+    if (arg->type != BLD_HANDLE_POSITIONAL_VARGS) {log_fatal(LOG_FATAL_PREFIX "no varg");}
+    varg = &arg->as.vargs;
+
+    all = set_has(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_targets_flag_all)));
+    if (all && varg->values.size > 0) {
+        error = -1;
+        err = string_pack("cannot both specify targets and --all\n");
+        err = string_copy(&err);
+        goto parse_failed;
+    } else if (!all && varg->values.size <= 0) {
+        error = -1;
+        err = string_pack("expected targets to build or --all\n");
+        err = string_copy(&err);
+        goto parse_failed;
+    }
+
+    cmd->targets = array_new(sizeof(bld_string));
+    if (all) {
+        iter = iter_set(&data->targets);
+    } else {
+        iter = iter_array(&varg->values);
+    }
+
+    while (iter_next(&iter, (void**) &target)) {
+        bld_string temp;
+
+        if (!set_has(&data->targets, string_hash(string_unpack(target)))) {
+            error = -1;
+            err = string_new();
+            string_append_string(&err, "'");
+            string_append_string(&err, string_unpack(target));
+            string_append_string(&err, "' is not a target\n");
+            goto free_targets;
+        }
+
+        temp = string_copy(target);
+        array_push(&cmd->targets, &temp);
+    }
+
+    qsort(cmd->targets.values, cmd->targets.size, cmd->targets.value_size, command_build_targets_compare);
+    for (i = 1; i < cmd->targets.size; i++) {
+        bld_string* previous;
+
+        previous = array_get(&cmd->targets, i - 1);
+        target = array_get(&cmd->targets, i);
+        if (strcmp(target->chars, previous->chars) == 0) {
+            error = -1;
+            err = string_new();
+            string_append_string(&err, "target '");
+            string_append_string(&err, string_unpack(target));
+            string_append_string(&err, "' specified multiple times\n");
+            goto free_targets;
+        }
+    }
+
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_trace)));
+    cmd->trace = flag != NULL;
+    cmd->mem_stats = set_has(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_mem_stats)));
+    if (command_build_parse_jobs(pre_cmd, &cmd->jobs, &err)) {
+        error = -1;
+        goto free_targets;
+    }
+    if (cmd->trace) {
+        cmd->trace_path = string_copy(&flag->value);
+    }
+
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_build_flag_profile)));
+    cmd->profile = flag != NULL;
+    if (cmd->profile) {
+        cmd->profile_name = string_copy(&flag->value);
+    }
+
+    return 0;
+    free_targets:
+    iter = iter_array(&cmd->targets);
+    while (iter_next(&iter, (void**) &target)) {
+        string_free(target);
+    }
+    array_free(&cmd->targets);
+    parse_failed:
+    *invalid = command_invalid_new(error, &err);
+    return -1;
+}
+
+bld_handle_annotated command_handle_build_targets(char* name) {
+    bld_handle_annotated handle;
+
+    handle.type = BLD_COMMAND_BUILD_TARGETS;
+    handle.name = bld_command_string_build_targets;
+    handle.handle = handle_new(name);
+    handle_positional_expect(&handle.handle, string_unpack(&bld_command_string_build_targets));
+    handle_allow_flags(&handle.handle);
+    handle_positional_vargs(&handle.handle, "The targets to build");
+    handle_flag(&handle.handle, ' ', string_unpack(&bld_command_string_build_targets_flag_all), "Build every target of the project");
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_build_flag_trace), "Write a Chrome trace-event file of the build phases and compile jobs to the given path");
+    handle_flag_value(&handle.handle, 'j', string_unpack(&bld_command_string_build_flag_jobs), "Maximum number of files compiled in parallel, defaults to the number of processors");
+    handle_flag(&handle.handle, ' ', string_unpack(&bld_command_string_build_flag_mem_stats), "Report allocations, bytes and peak memory of each build phase");
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_build_flag_profile), "Build every target with the flags of its profile of this name");
+    handle_set_description(
+        &handle.handle,
+        "Builds several targets in one invocation, see `bld help` for building\n"
+        "a single target.\n"
+        "\n"
+        "The project is indexed once and directory listings, file information\n"
+        "and scanned includes are shared between the targets. The files that\n"
+        "have to be compiled for any of the targets are compiled by one shared\n"
+        "pool of jobs, every target still keeps its own cache and executable."
+    );
+
+    handle.convert = (bld_command_convert*) command_build_targets_convert;
+    handle.execute = (bld_command_execute*) command_build_targets;
+    handle.free = (bld_command_free*) command_build_targets_free;
+
+    return handle;
+}
+
+void command_build_targets_free(bld_command_build_targets* cmd) {
+    bld_iter iter;
+    bld_string* target;
+
+    iter = iter_array(&cmd->targets);
+    while (iter_next(&iter, (void**) &target)) {
+        string_free(target);
+    }
+    array_free(&cmd->targets);
+
+    if (cmd->trace) {
+        string_free(&cmd->trace_path);
+    }
+    if (cmd->profile) {
+        string_free(&cmd->profile_name);
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef COMMAND_BUILD_TARGETS_H
+#define COMMAND_BUILD_TARGETS_H
+#include "../bld_core/dstr.h"
+#include "../bld_core/args.h"
+#include "handle.h"
+#include "invalid.h"
+
+extern const bld_string bld_command_string_build_targets;
+
+typedef struct bld_command_build_targets {
+    bld_array targets;
+    int trace;
+    bld_string trace_path;
+    int jobs;
+    int mem_stats;
+    int profile;
+    bld_string profile_name;
+} bld_command_build_targets;
+
+bld_handle_annotated command_handle_build_targets(char*);
+int command_build_targets_convert(bld_command*, bld_data*, bld_command_build_targets*, bld_command_invalid*);
+int command_build_targets(bld_command_build_targets*, bld_data*);
+void command_build_targets_free(bld_command_build_targets*);
+
+#endif
@@ -4,7 +4,11 @@
 #include "utils.h"
 #include "add.h"
 #include "build.h"
+#include "build_targets.h"
 #include "compiler.h"
+#include "explain.h"
+#include "analyze.h"
+#include "profile.h"
 #include "help.h"
 #include "ignore.h"
 #include "init.h"
@@ -12,8 +16,10 @@
 #include "invalidate.h"
 #include "linker.h"
 #include "remove.h"
+#include "stats.h"
 #include "status.h"
 #include "switch.h"
+#include "command_test.h"
 
 typedef union bld_union_command {
     bld_command_invalid invalid;
@@ -23,11 +29,17 @@ typedef union bld_union_command {
     bld_command_help help;
     bld_command_add add;
     bld_command_build build;
+    bld_command_build_targets build_targets;
     bld_command_compiler compiler;
     bld_command_ignore ignore;
     bld_command_invalidate invalidate;
     bld_command_linker linker;
     bld_command_status status;
+    bld_command_test test;
+    bld_command_stats stats;
+    bld_command_explain explain;
+    bld_command_analyze analyze;
+    bld_command_profile profile;
 } bld_union_command;
 
 typedef struct bld_application_command {
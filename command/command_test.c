@@ -22,7 +22,7 @@ int command_test(bld_command_test* cmd, bld_data* data) {
         return -1;
     }
 
-    fproject = command_build_project_new(&cmd->target, data);
+    fproject = command_build_project_new(&cmd->target, NULL, data);
     project = project_resolve(&fproject);
 
     test_files = project_tests_under(&project, &cmd->test_path);
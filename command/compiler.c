@@ -189,12 +189,14 @@ int command_compiler(bld_command_compiler* cmd, bld_data* data) {
             file->info.compiler_set = 1;
             file->info.compiler.type = BLD_COMPILER_FLAGS;
             file->info.compiler.as.flags.removed = set_new(sizeof(bld_string));
+            set_verify_keys(&file->info.compiler.as.flags.removed, string_key_eq);
 
             flags = &file->info.compiler.as.flags;
         }
 
         flags->flags = array_new(sizeof(bld_string));
-        flags->flag_hash = set_new(0);
+        flags->flag_hash = set_new(sizeof(bld_string));
+        set_verify_keys(&flags->flag_hash, string_key_eq);
         iter = iter_array(&cmd->flags);
         while (iter_next(&iter, (void**) &flag)) {
             bld_string temp;
@@ -234,12 +236,14 @@ int command_compiler(bld_command_compiler* cmd, bld_data* data) {
             file->info.compiler_set = 1;
             file->info.compiler.type = BLD_COMPILER_FLAGS;
             file->info.compiler.as.flags.flags = array_new(sizeof(bld_string));
-            file->info.compiler.as.flags.flag_hash = set_new(0);
+            file->info.compiler.as.flags.flag_hash = set_new(sizeof(bld_string));
+            set_verify_keys(&file->info.compiler.as.flags.flag_hash, string_key_eq);
 
             flags = &file->info.compiler.as.flags;
         }
 
         flags->removed = set_new(sizeof(bld_string));
+        set_verify_keys(&flags->removed, string_key_eq);
         iter = iter_array(&cmd->flags);
         while (iter_next(&iter, (void**) &flag)) {
             bld_string temp;
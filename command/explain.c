@@ -0,0 +1,192 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../bld_core/iter.h"
+#include "../bld_core/logging.h"
+#include "../bld_core/incremental.h"
+#include "init.h"
+#include "build.h"
+#include "explain.h"
+
+const bld_string bld_command_string_explain = STRING_COMPILE_TIME_PACK("explain");
+
+typedef struct bld_explain_entry {
+    bld_file* file;
+    bld_change* change;
+} bld_explain_entry;
+
+int command_explain_entry_compare(const void*, const void*);
+void command_explain_print(bld_project*, bld_explain_entry*);
+
+int command_explain(bld_command_explain* cmd, bld_data* data) {
+    size_t units;
+    bld_iter iter;
+    bld_file* file;
+    bld_set changes;
+    bld_array entries;
+    bld_explain_entry* entry;
+    bld_forward_project fproject;
+    bld_project project;
+
+    set_log_level(data->config.log_level);
+
+    os_stat_cache_start();
+    fproject = command_build_project_new(&cmd->target, NULL, data);
+    project = project_resolve(&fproject);
+    changes = incremental_explain_project(&project);
+    os_stat_cache_stop();
+
+    units = 0;
+    entries = array_new(sizeof(bld_explain_entry));
+    iter = iter_set(&project.files);
+    while (iter_next(&iter, (void**) &file)) {
+        bld_explain_entry entry;
+
+        if (file->type == BLD_FILE_INTERFACE || file->type == BLD_FILE_DIRECTORY) {continue;}
+        units += 1;
+
+        entry.file = file;
+        entry.change = set_get(&changes, file->identifier.id);
+        if (entry.change->reason == BLD_CHANGE_NONE) {continue;}
+
+        array_push(&entries, &entry);
+    }
+
+    qsort(entries.values, entries.size, entries.value_size, command_explain_entry_compare);
+
+    printf("Target: %s\n", string_unpack(&cmd->target));
+    printf("%lu of %lu file(s) will be compiled\n", (unsigned long) entries.size, (unsigned long) units);
+
+    iter = iter_array(&entries);
+    while (iter_next(&iter, (void**) &entry)) {
+        command_explain_print(&project, entry);
+    }
+
+    array_free(&entries);
+    set_free(&changes);
+    project_free(&project);
+    return 0;
+}
+
+int command_explain_entry_compare(const void* a, const void* b) {
+    const bld_explain_entry* e1 = a;
+    const bld_explain_entry* e2 = b;
+
+    return strcmp(path_to_string(&e1->file->path), path_to_string(&e2->file->path));
+}
+
+void command_explain_print(bld_project* project, bld_explain_entry* entry) {
+    bld_change* change;
+
+    change = entry->change;
+    printf("  %s: ", path_to_string(&entry->file->path));
+
+    switch (change->reason) {
+        case (BLD_CHANGE_NO_CACHE): {
+            printf("no cache, first build of target\n");
+        } break;
+        case (BLD_CHANGE_NOT_CACHED): {
+            printf("not in cache\n");
+        } break;
+        case (BLD_CHANGE_HASH): {
+            int any;
+
+            any = 0;
+            printf("hash changed (");
+            if (change->mtime) {
+                printf("mtime");
+                any = 1;
+            }
+            if (change->compiler) {
+                printf("%scompiler flags", any ? ", " : "");
+                any = 1;
+            }
+            if (change->linker) {
+                printf("%slinker flags", any ? ", " : "");
+                any = 1;
+            }
+            if (!any) {
+                printf("file moved or changed type");
+            }
+            printf(")\n");
+        } break;
+        case (BLD_CHANGE_INCLUDE): {
+            bld_file* header;
+
+            if (change->include == BLD_INVALID_IDENITIFIER) {
+                printf("includes a file which no longer exists\n");
+                break;
+            }
+
+            header = set_get(&project->files, change->include);
+            if (header == NULL) {log_fatal(LOG_FATAL_PREFIX "unreachable error");}
+            printf("includes changed file \"%s\"\n", path_to_string(&header->path));
+        } break;
+        case (BLD_CHANGE_OBJECT_MISSING): {
+            printf("object file missing\n");
+        } break;
+        default: {log_fatal(LOG_FATAL_PREFIX "unrecognized reason %d", change->reason);}
+    }
+}
+
+int command_explain_convert(bld_command* pre_cmd, bld_data* data, bld_command_explain* cmd, bld_command_invalid* invalid) {
+    int error;
+    bld_string err;
+    bld_command_positional* arg;
+    bld_command_positional_optional* target;
+
+    if (!data->has_root) {
+        error = -1;
+        err = string_copy(&bld_command_init_missing_project);
+        goto parse_failed;
+    }
+
+    if (data->targets.size == 0) {
+        error = -1;
+        err = string_copy(&bld_command_init_no_targets);
+        goto parse_failed;
+    }
+
+    arg = array_get(&pre_cmd->positional, 0);
+    if (arg->type != BLD_HANDLE_POSITIONAL_OPTIONAL) {log_fatal(LOG_FATAL_PREFIX "missing first optional");}
+    target = &arg->as.opt;
+
+    if (!utils_get_target(&cmd->target, &err, target, data)) {
+        error = -1;
+        goto parse_failed;
+    }
+
+    return 0;
+    parse_failed:
+    *invalid = command_invalid_new(error, &err);
+    return -1;
+}
+
+bld_handle_annotated command_handle_explain(char* name) {
+    bld_handle_annotated handle;
+
+    handle.type = BLD_COMMAND_EXPLAIN;
+    handle.name = bld_command_string_explain;
+    handle.handle = handle_new(name);
+    handle_positional_optional(&handle.handle, "The target to explain");
+    handle_positional_expect(&handle.handle, string_unpack(&bld_command_string_explain));
+    handle_set_description(
+        &handle.handle,
+        "Shows which files the next build of a target will compile and why,\n"
+        "without compiling or linking anything and without touching the cache.\n"
+        "\n"
+        "A file is compiled if it is not in the cache, if its hash changed\n"
+        "because of its modification time or the compiler or linker flags\n"
+        "applied to it, if a file it includes changed or if its object file\n"
+        "is missing."
+    );
+
+    handle.convert = (bld_command_convert*) command_explain_convert;
+    handle.execute = (bld_command_execute*) command_explain;
+    handle.free = (bld_command_free*) command_explain_free;
+
+    return handle;
+}
+
+void command_explain_free(bld_command_explain* cmd) {
+    string_free(&cmd->target);
+}
@@ -0,0 +1,19 @@
+#ifndef COMMAND_EXPLAIN_H
+#define COMMAND_EXPLAIN_H
+#include "../bld_core/dstr.h"
+#include "../bld_core/args.h"
+#include "handle.h"
+#include "invalid.h"
+
+extern const bld_string bld_command_string_explain;
+
+typedef struct bld_command_explain {
+    bld_string target;
+} bld_command_explain;
+
+bld_handle_annotated command_handle_explain(char*);
+int command_explain_convert(bld_command*, bld_data*, bld_command_explain*, bld_command_invalid*);
+int command_explain(bld_command_explain*, bld_data*);
+void command_explain_free(bld_command_explain*);
+
+#endif
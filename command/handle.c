@@ -6,6 +6,8 @@
 typedef struct bld_handle_info {
     int current_arg;
     int current_expected;
+    int expects_value;
+    uintmax_t value_flag;
     bld_array expected_index;
     int* positional_parsed;
 } bld_handle_info;
@@ -17,6 +19,8 @@ bld_command_error handle_parse_optional(bld_string*, bld_handle_info*, bld_handl
 bld_command_error handle_parse_expected(bld_string*, bld_handle_info*, bld_handle*, bld_command*, bld_array*);
 bld_command_error handle_parse_vargs(bld_string*, bld_handle_info*, bld_handle*, bld_command*, bld_array*);
 bld_command_error handle_parse_flag(bld_string*, bld_handle_info*, bld_handle*, bld_command*, bld_array*);
+bld_command_error handle_parse_flag_value(bld_string*, bld_handle_info*, bld_handle*, bld_command*, bld_array*);
+void handle_add_flag(bld_handle*, char, char*, char*, int);
 
 bld_command command_new(bld_handle*);
 void command_free_internal(bld_command*, bld_handle_info*);
@@ -210,6 +214,14 @@ void handle_set_description(bld_handle* handle, char* description) {
 }
 
 void handle_flag(bld_handle* handle, char swtch, char* option, char* description) {
+    handle_add_flag(handle, swtch, option, description, 0);
+}
+
+void handle_flag_value(bld_handle* handle, char swtch, char* option, char* description) {
+    handle_add_flag(handle, swtch, option, description, 1);
+}
+
+void handle_add_flag(bld_handle* handle, char swtch, char* option, char* description, int has_value) {
     size_t index = handle->flag_array.size;
     bld_string opt, desc;
     bld_handle_flag flag;
@@ -219,6 +231,7 @@ void handle_flag(bld_handle* handle, char swtch, char* option, char* description
 
     flag.description = string_copy(&desc);
     flag.swtch = swtch;
+    flag.has_value = has_value;
     flag.option = string_copy(&opt);
 
     array_push(&handle->flag_array, &flag);
@@ -308,6 +321,9 @@ void command_free(bld_command* cmd) {
     iter = iter_set(&cmd->flags);
     while (iter_next(&iter, (void**) &flag)) {
         string_free(&flag->flag);
+        if (flag->has_value) {
+            string_free(&flag->value);
+        }
     }
     set_free(&cmd->flags);
 
@@ -360,6 +376,9 @@ void command_free_internal(bld_command* cmd, bld_handle_info* info) {
     iter = iter_set(&cmd->flags);
     while (iter_next(&iter, (void**) &flag)) {
         string_free(&flag->flag);
+        if (flag->has_value) {
+            string_free(&flag->value);
+        }
     }
     set_free(&cmd->flags);
 
@@ -404,6 +423,8 @@ bld_handle_info handle_info_new(bld_handle* handle) {
 
     info.current_arg = 0;
     info.current_expected = 0;
+    info.expects_value = 0;
+    info.value_flag = 0;
     return info;
 }
 
@@ -429,6 +450,11 @@ int handle_parse(bld_args args, bld_handle* handle, bld_command* cmd, bld_array*
     while (!args_empty(&args)) {
         bld_string arg = args_advance(&args);
 
+        if (info.expects_value) {
+            error |= handle_parse_flag_value(&arg, &info, handle, cmd, err);
+            continue;
+        }
+
         if (*arg.chars != '-' || string_eq(&arg, &empty_switch) || string_eq(&arg, &empty_option)) {
             if (((size_t) info.current_arg) < handle->positional.size) {
                 pos = array_get(&handle->positional, info.current_arg);
@@ -468,6 +494,20 @@ int handle_parse(bld_args args, bld_handle* handle, bld_command* cmd, bld_array*
         }
     }
 
+    if (info.expects_value) {
+        bld_string str;
+        bld_command_flag* flag;
+
+        flag = set_get(&cmd->flags, info.value_flag);
+        if (flag == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
+
+        str = string_new();
+        string_append_string(&str, "Expected a value after flag \"");
+        string_append_string(&str, string_unpack(&flag->flag));
+        string_append_string(&str, "\"");
+        array_push(err, &str);
+        error |= BLD_COMMAND_ERROR_FLAG_VALUE;
+    }
 
     index = -1;
     too_few = 0;
@@ -668,10 +708,17 @@ bld_command_error handle_parse_flag(bld_string* arg, bld_handle_info* info, bld_
 
         flag.is_switch = is_switch;
         flag.flag = string_copy(&handle_flag->option);
+        flag.has_value = handle_flag->has_value;
+        if (flag.has_value) {
+            flag.value = string_new();
+            info->expects_value = 1;
+            info->value_flag = string_hash(string_unpack(&handle_flag->option));
+        }
         set_add(&cmd->flags, string_hash(string_unpack(&handle_flag->option)), &flag);
     } else if (handle->arbitrary_flags) {
         flag.is_switch = is_switch;
         flag.flag = string_copy(&flag_str);
+        flag.has_value = 0;
         array_push(&cmd->extra_flags, &flag);
     } else {
         bld_string str;
@@ -686,7 +733,21 @@ bld_command_error handle_parse_flag(bld_string* arg, bld_handle_info* info, bld_
         return BLD_COMMAND_ERROR_FLAG_UNKNOWN;
     }
 
-    (void)(info);
+    return 0;
+}
+
+bld_command_error handle_parse_flag_value(bld_string* arg, bld_handle_info* info, bld_handle* handle, bld_command* cmd, bld_array* err) {
+    bld_command_flag* flag;
+
+    flag = set_get(&cmd->flags, info->value_flag);
+    if (flag == NULL) {log_fatal(LOG_FATAL_PREFIX "internal error");}
+
+    string_free(&flag->value);
+    flag->value = string_copy(arg);
+    info->expects_value = 0;
+
+    (void)(handle);
+    (void)(err);
     return 0;
 }
 
@@ -747,6 +808,9 @@ bld_string handle_make_description(bld_handle* handle) {
         }
         string_append_char(&description, '-');
         string_append_string(&description, string_unpack(&flag->option));
+        if (flag->has_value) {
+            string_append_string(&description, " <value>");
+        }
         string_append_char(&description, ']');
     }
 
@@ -797,6 +861,9 @@ bld_string handle_make_description(bld_handle* handle) {
         }
         string_append_char(&description, '-');
         string_append_string(&description, string_unpack(&flag->option));
+        if (flag->has_value) {
+            string_append_string(&description, " <value>");
+        }
         string_append_string(&description, " ");
         string_append_string(&description, string_unpack(&flag->description));
     }
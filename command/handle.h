@@ -22,6 +22,7 @@ typedef struct bld_handle_positional {
 
 typedef struct bld_handle_flag {
     char swtch;
+    int has_value;
     bld_string option;
     bld_string description;
 } bld_handle_flag;
@@ -70,6 +71,8 @@ typedef struct bld_command_positional {
 typedef struct bld_command_flag {
     int is_switch;
     bld_string flag;
+    int has_value;
+    bld_string value;
 } bld_command_flag;
 
 typedef enum bld_command_error {
@@ -79,7 +82,8 @@ typedef enum bld_command_error {
     BLD_COMMAND_ERROR_FLAG_UNKNOWN = (1 << 3),
     BLD_COMMAND_ERROR_FLAG_EMPTY = (1 << 4),
     BLD_COMMAND_ERROR_FLAG_DUPLICATE = (1 << 5),
-    BLD_COMMAND_ERROR_FLAG_EARLY = (1 << 6)
+    BLD_COMMAND_ERROR_FLAG_EARLY = (1 << 6),
+    BLD_COMMAND_ERROR_FLAG_VALUE = (1 << 7)
 } bld_command_error;
 
 typedef struct bld_command {
@@ -103,6 +107,7 @@ void handle_allow_arbitrary_flags(bld_handle*, char*);
 void handle_allow_flags(bld_handle*);
 
 void handle_flag(bld_handle*, char, char*, char*);
+void handle_flag_value(bld_handle*, char, char*, char*);
 void handle_set_description(bld_handle*, char*);
 
 #endif
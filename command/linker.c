@@ -29,7 +29,11 @@ int command_linker(bld_command_linker* cmd, bld_data* data) {
         printf("File:     %s\n", path_to_string(&cmd->path));
 
         if (is_root && data->target_config.linker_set) {
-            printf("Linker:   %s\n", string_unpack(&data->target_config.linker.executable));
+            if (linker_is_variant(data->target_config.linker.type)) {
+                printf("Linker:   %s (%s)\n", string_unpack(&data->target_config.linker.executable), string_unpack(linker_get_string(data->target_config.linker.type)));
+            } else {
+                printf("Linker:   %s\n", string_unpack(&data->target_config.linker.executable));
+            }
         }
 
         if (file->info.linker_set) {
@@ -63,6 +67,7 @@ int command_linker(bld_command_linker* cmd, bld_data* data) {
         bld_iter iter;
         bld_command_flag* flag;
         bld_linker* linker;
+        bld_linker_type type;
 
         if (!is_root) {
             log_fatal("Can only modify linker flags of non-root '%s', cannot change linker", path_to_string(&cmd->path));
@@ -78,7 +83,9 @@ int command_linker(bld_command_linker* cmd, bld_data* data) {
         }
 
         data->target_config.linker_set = 1;
-        *linker = linker_new(linker_get_mapping(&cmd->linker), string_unpack(&cmd->linker));
+        /* mold and lld are run through the compiler driver instead of being invoked directly */
+        type = linker_get_mapping(&cmd->linker);
+        *linker = linker_new(type, linker_is_variant(type) ? BLD_LINKER_DRIVER : string_unpack(&cmd->linker));
         file->info.linker_set = 1;
         file->info.linker_flags = linker_flags_new();
 
@@ -280,6 +287,13 @@ bld_handle_annotated command_handle_linker(char* name) {
         "        and when building the project this linker will be used to build\n"
         "        the project.\n"
     );
+    string_append_string(
+        &temp,
+        "\n"
+        "        The linkers mold and lld are used through the compiler driver\n"
+        "        `cc` with `-fuse-ld`, when they are not installed the default\n"
+        "        linker of the driver is used instead.\n"
+    );
     string_append_string(
         &temp,
         "\n"
@@ -0,0 +1,360 @@
+#include "../bld_core/iter.h"
+#include "../bld_core/logging.h"
+#include "../bld_core/os.h"
+#include "init.h"
+#include "profile.h"
+
+const bld_string bld_command_string_profile = STRING_COMPILE_TIME_PACK("profile");
+
+void command_profile_print(bld_command_profile*, bld_config_profile*);
+void command_profile_print_flags(char*, bld_iter*);
+bld_string command_profile_flag(bld_command_flag*);
+
+int command_profile(bld_command_profile* cmd, bld_data* data) {
+    bld_iter iter;
+    bld_command_flag* flag;
+    bld_config_profile* profile;
+
+    set_log_level(data->config.log_level);
+
+    config_target_load(data, &cmd->target);
+    if (!data->target_config_parsed) {
+        log_fatal("Config for target '%s' could not be parsed", string_unpack(&cmd->target));
+    }
+
+    if (cmd->type == BLD_COMMAND_PROFILE_LIST) {
+        printf("Target:   %s\n", string_unpack(&cmd->target));
+        if (data->target_config.profiles.size == 0) {
+            printf("No profiles set\n");
+            return 0;
+        }
+
+        printf("Profiles:\n");
+        iter = iter_array(&data->target_config.profiles);
+        while (iter_next(&iter, (void**) &profile)) {
+            printf("    %s\n", string_unpack(&profile->name));
+        }
+        return 0;
+    }
+
+    profile = config_target_get_profile(&data->target_config, &cmd->name);
+    if (cmd->type == BLD_COMMAND_PROFILE_PRINT) {
+        if (profile == NULL) {
+            log_error("Target '%s' has no profile '%s'", string_unpack(&cmd->target), string_unpack(&cmd->name));
+            return -1;
+        }
+        command_profile_print(cmd, profile);
+        return 0;
+    }
+
+    if (cmd->type == BLD_COMMAND_PROFILE_CLEAR) {
+        size_t i;
+        bld_path cache;
+
+        if (profile == NULL) {
+            log_error("Target '%s' has no profile '%s'", string_unpack(&cmd->target), string_unpack(&cmd->name));
+            return -1;
+        }
+
+        cache = path_copy(&data->root);
+        path_append_string(&cache, ".bld");
+        path_append_string(&cache, "target");
+        path_append_string(&cache, string_unpack(&cmd->target));
+        path_append_string(&cache, "profiles");
+        path_append_string(&cache, string_unpack(&cmd->name));
+        if (os_dir_exists(path_to_string(&cache)) && os_dir_remove(path_to_string(&cache))) {
+            log_warn("Could not remove cache of profile '%s'", string_unpack(&cmd->name));
+        }
+        path_free(&cache);
+
+        i = profile - (bld_config_profile*) data->target_config.profiles.values;
+        config_profile_free(profile);
+        array_remove(&data->target_config.profiles, i);
+        config_target_save(data, &cmd->target);
+        return 0;
+    }
+
+    if (profile == NULL) {
+        bld_config_profile temp;
+
+        temp = config_profile_new(string_unpack(&cmd->name));
+        array_push(&data->target_config.profiles, &temp);
+        profile = array_get(&data->target_config.profiles, data->target_config.profiles.size - 1);
+    }
+
+    if (cmd->type == BLD_COMMAND_PROFILE_ADD_FLAGS || cmd->type == BLD_COMMAND_PROFILE_REMOVE_FLAGS) {
+        bld_compiler_flags flags;
+        bld_compiler_flags* previous;
+
+        /* The other half of the overlay is kept, the given flags replace this half */
+        previous = &profile->compiler_flags;
+        flags = compiler_flags_new();
+        if (cmd->type == BLD_COMMAND_PROFILE_ADD_FLAGS) {
+            bld_string* removed;
+
+            iter = iter_set(&previous->removed);
+            while (iter_next(&iter, (void**) &removed)) {
+                compiler_flags_remove_flag(&flags, string_unpack(removed));
+            }
+        } else {
+            bld_string* added;
+
+            iter = iter_array(&previous->flags);
+            while (iter_next(&iter, (void**) &added)) {
+                compiler_flags_add_flag(&flags, string_unpack(added));
+            }
+        }
+
+        iter = iter_array(&cmd->flags);
+        while (iter_next(&iter, (void**) &flag)) {
+            bld_string temp;
+            uintmax_t hash;
+
+            temp = command_profile_flag(flag);
+            hash = string_hash(string_unpack(&temp));
+            if (set_has_key(&flags.flag_hash, hash, &temp) || set_has_key(&flags.removed, hash, &temp)) {
+                log_fatal("Flag \"%s\" is both added and removed by profile '%s'", string_unpack(&temp), string_unpack(&cmd->name));
+            }
+
+            if (cmd->type == BLD_COMMAND_PROFILE_ADD_FLAGS) {
+                compiler_flags_add_flag(&flags, string_unpack(&temp));
+            } else {
+                compiler_flags_remove_flag(&flags, string_unpack(&temp));
+            }
+            string_free(&temp);
+        }
+
+        compiler_flags_free(previous);
+        *previous = flags;
+    } else if (cmd->type == BLD_COMMAND_PROFILE_LINKER_FLAGS) {
+        linker_flags_free(&profile->linker_flags);
+        profile->linker_flags = linker_flags_new();
+
+        iter = iter_array(&cmd->flags);
+        while (iter_next(&iter, (void**) &flag)) {
+            bld_string temp;
+
+            temp = command_profile_flag(flag);
+            linker_flags_add_flag(&profile->linker_flags, string_unpack(&temp));
+            string_free(&temp);
+        }
+    } else {
+        log_fatal("command_profile: unknown command type");
+    }
+
+    config_target_save(data, &cmd->target);
+    return 0;
+}
+
+void command_profile_print(bld_command_profile* cmd, bld_config_profile* profile) {
+    bld_iter iter;
+    bld_compiler_flags* flags;
+
+    printf("Target:   %s\n", string_unpack(&cmd->target));
+    printf("Profile:  %s\n", string_unpack(&profile->name));
+
+    flags = &profile->compiler_flags;
+    if (flags->flags.size > 0 || flags->removed.size > 0) {
+        printf("Flags:\n");
+    }
+    if (flags->flags.size > 0) {
+        iter = iter_array(&flags->flags);
+        command_profile_print_flags("    Added:   ", &iter);
+    }
+    if (flags->removed.size > 0) {
+        iter = iter_set(&flags->removed);
+        command_profile_print_flags("    Removed: ", &iter);
+    }
+
+    if (profile->linker_flags.flags.size > 0) {
+        iter = iter_array(&profile->linker_flags.flags);
+        command_profile_print_flags("Linker:   ", &iter);
+    }
+
+    if (flags->flags.size == 0 && flags->removed.size == 0 && profile->linker_flags.flags.size == 0) {
+        printf("No flags set\n");
+    }
+}
+
+void command_profile_print_flags(char* label, bld_iter* iter) {
+    int first;
+    bld_string* flag;
+
+    printf("%s[", label);
+    first = 1;
+    while (iter_next(iter, (void**) &flag)) {
+        if (!first) {
+            printf(", ");
+        }
+        first = 0;
+        printf("%s", string_unpack(flag));
+    }
+    printf("]\n");
+}
+
+bld_string command_profile_flag(bld_command_flag* flag) {
+    bld_string temp;
+
+    temp = string_new();
+    if (flag->is_switch) {
+        string_append_string(&temp, "-");
+    } else {
+        string_append_string(&temp, "--");
+    }
+    string_append_string(&temp, string_unpack(&flag->flag));
+    return temp;
+}
+
+int command_profile_convert(bld_command* pre_cmd, bld_data* data, bld_command_profile* cmd, bld_command_invalid* invalid) {
+    bld_string err;
+    bld_command_positional* arg;
+    bld_command_positional_optional* target;
+    bld_command_positional_optional* name;
+    bld_command_positional_optional* option;
+
+    if (!data->has_root) {
+        err = string_copy(&bld_command_init_missing_project);
+        goto parse_failed;
+    }
+
+    if (data->targets.size == 0) {
+        err = string_copy(&bld_command_init_no_targets);
+        goto parse_failed;
+    }
+
+    arg = array_get(&pre_cmd->positional, 0);
+    if (arg->type != BLD_HANDLE_POSITIONAL_OPTIONAL) {log_fatal("command_profile_convert: missing first optional");}
+    target = &arg->as.opt;
+
+    if (!utils_get_target(&cmd->target, &err, target, data)) {
+        goto parse_failed;
+    }
+
+    arg = array_get(&pre_cmd->positional, 2);
+    if (arg->type != BLD_HANDLE_POSITIONAL_OPTIONAL) {log_fatal("command_profile_convert: missing name");}
+    name = &arg->as.opt;
+
+    arg = array_get(&pre_cmd->positional, 3);
+    if (arg->type != BLD_HANDLE_POSITIONAL_OPTIONAL) {log_fatal("command_profile_convert: missing option");}
+    option = &arg->as.opt;
+
+    cmd->flags = array_new(sizeof(bld_command_flag));
+    if (!name->present) {
+        cmd->type = BLD_COMMAND_PROFILE_LIST;
+        return 0;
+    }
+    if (!config_profile_name_valid(&name->value)) {
+        array_free(&cmd->flags);
+        string_free(&cmd->target);
+        err = string_new();
+        string_append_string(&err, "Invalid profile name '");
+        string_append_string(&err, string_unpack(&name->value));
+        string_append_string(&err, "', a name cannot be empty, '.', '..' or contain a path separator\n");
+        goto parse_failed;
+    }
+    cmd->name = string_copy(&name->value);
+
+    if (option->present) {
+        bld_string add, remove, ll, clear;
+
+        add = string_pack("++");
+        remove = string_pack("--");
+        ll = string_pack("ll");
+        clear = string_pack("clear");
+        if (string_eq(&option->value, &add)) {
+            cmd->type = BLD_COMMAND_PROFILE_ADD_FLAGS;
+        } else if (string_eq(&option->value, &remove)) {
+            cmd->type = BLD_COMMAND_PROFILE_REMOVE_FLAGS;
+        } else if (string_eq(&option->value, &ll)) {
+            cmd->type = BLD_COMMAND_PROFILE_LINKER_FLAGS;
+        } else if (string_eq(&option->value, &clear)) {
+            cmd->type = BLD_COMMAND_PROFILE_CLEAR;
+        } else {
+            string_free(&cmd->target);
+            string_free(&cmd->name);
+            array_free(&cmd->flags);
+            err = string_new();
+            string_append_string(&err, "Expected option to add or remove compiler flags or set linker flags with ++/--/ll/clear, got ");
+            string_append_string(&err, string_unpack(&option->value));
+            string_append_char(&err, '\n');
+            goto parse_failed;
+        }
+
+        array_free(&cmd->flags);
+        cmd->flags = pre_cmd->extra_flags;
+        pre_cmd->extra_flags = array_new(sizeof(bld_command_flag));
+    } else {
+        cmd->type = BLD_COMMAND_PROFILE_PRINT;
+    }
+
+    return 0;
+    parse_failed:
+    *invalid = command_invalid_new(-1, &err);
+    return -1;
+}
+
+bld_handle_annotated command_handle_profile(char* name) {
+    bld_string temp;
+    bld_handle_annotated handle;
+
+    handle.type = BLD_COMMAND_PROFILE;
+    handle.name = bld_command_string_profile;
+    handle.handle = handle_new(name);
+    handle_positional_optional(&handle.handle, "Target to set the profile of");
+    handle_positional_expect(&handle.handle, string_unpack(&bld_command_string_profile));
+    handle_positional_optional(&handle.handle, "Name of the profile");
+    handle_positional_optional(&handle.handle, "Add or remove compiler flags with ++ or --, set linker flags with ll");
+    handle_allow_flags(&handle.handle);
+    handle_allow_arbitrary_flags(&handle.handle, "Arbitrary flags can be specified which will be added to or removed from the profile");
+
+    temp = string_new();
+    string_append_string(
+        &temp,
+        "Set or view the profiles of a target. A profile is a named overlay on\n"
+        "the compiler and linker flags of the root of the target, it is selected\n"
+        "with `bld <target> --profile <name>`. Every profile keeps its own cache\n"
+        "so switching between profiles does not recompile anything.\n"
+        "\n"
+        "    `bld <target> profile <name> ++ <flags...>`:\n"
+        "        Sets the compiler flags the profile adds.\n"
+    );
+    string_append_string(
+        &temp,
+        "\n"
+        "    `bld <target> profile <name> -- <flags...>`:\n"
+        "        Sets the compiler flags the profile removes from the root.\n"
+        "\n"
+        "    `bld <target> profile <name> ll <flags...>`:\n"
+        "        Sets the linker flags the profile adds.\n"
+        "\n"
+        "    `bld <target> profile <name> clear`:\n"
+        "        Removes the profile.\n"
+        "\n"
+        "To list the profiles of a target run `bld <target> profile`."
+    );
+
+    handle_set_description(&handle.handle, string_unpack(&temp));
+
+    handle.convert = (bld_command_convert*) command_profile_convert;
+    handle.execute = (bld_command_execute*) command_profile;
+    handle.free = (bld_command_free*) command_profile_free;
+
+    string_free(&temp);
+    return handle;
+}
+
+void command_profile_free(bld_command_profile* cmd) {
+    bld_iter iter;
+    bld_command_flag* flag;
+
+    string_free(&cmd->target);
+    if (cmd->type != BLD_COMMAND_PROFILE_LIST) {
+        string_free(&cmd->name);
+    }
+
+    iter = iter_array(&cmd->flags);
+    while (iter_next(&iter, (void**) &flag)) {
+        string_free(&flag->flag);
+    }
+    array_free(&cmd->flags);
+}
@@ -0,0 +1,31 @@
+#ifndef COMMAND_PROFILE_H
+#define COMMAND_PROFILE_H
+#include "../bld_core/dstr.h"
+#include "../bld_core/args.h"
+#include "handle.h"
+#include "invalid.h"
+
+extern const bld_string bld_command_string_profile;
+
+typedef enum bld_command_profile_type {
+    BLD_COMMAND_PROFILE_LIST,
+    BLD_COMMAND_PROFILE_PRINT,
+    BLD_COMMAND_PROFILE_ADD_FLAGS,
+    BLD_COMMAND_PROFILE_REMOVE_FLAGS,
+    BLD_COMMAND_PROFILE_LINKER_FLAGS,
+    BLD_COMMAND_PROFILE_CLEAR
+} bld_command_profile_type;
+
+typedef struct bld_command_profile {
+    bld_string target;
+    bld_command_profile_type type;
+    bld_string name;
+    bld_array flags;
+} bld_command_profile;
+
+bld_handle_annotated command_handle_profile(char*);
+int command_profile_convert(bld_command*, bld_data*, bld_command_profile*, bld_command_invalid*);
+int command_profile(bld_command_profile*, bld_data*);
+void command_profile_free(bld_command_profile*);
+
+#endif
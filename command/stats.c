@@ -0,0 +1,275 @@
+#include <stdlib.h>
+#include <string.h>
+#include "../bld_core/iter.h"
+#include "../bld_core/logging.h"
+#include "../bld_core/incremental.h"
+#include "init.h"
+#include "build.h"
+#include "stats.h"
+
+const bld_string bld_command_string_stats = STRING_COMPILE_TIME_PACK("stats");
+const bld_string bld_command_string_stats_flag_regression = STRING_COMPILE_TIME_PACK("regression");
+
+typedef struct bld_stats_entry {
+    bld_time latest;
+    bld_time previous;
+    bld_file* file;
+} bld_stats_entry;
+
+int command_stats_entry_compare(const void*, const void*);
+void command_stats_print_time(char*, bld_time);
+void command_stats_builds(bld_array*);
+void command_stats_slowest(bld_array*);
+void command_stats_critical_path(bld_array*);
+void command_stats_regressions(bld_array*, int);
+
+int command_stats(bld_command_stats* cmd, bld_data* data) {
+    bld_iter iter;
+    bld_file* file;
+    bld_array entries;
+    bld_forward_project fproject;
+    bld_project project;
+
+    set_log_level(data->config.log_level);
+
+    fproject = command_build_project_new(&cmd->target, NULL, data);
+    project = project_resolve(&fproject);
+
+    printf("Target: %s\n", string_unpack(&cmd->target));
+    if (!project.base.cache.set || project.base.cache.builds.size == 0) {
+        printf("No builds recorded, build the target with `bld %s` first\n", string_unpack(&cmd->target));
+        project_free(&project);
+        return 0;
+    }
+
+    entries = array_new(sizeof(bld_stats_entry));
+    iter = iter_set(&project.files);
+    while (iter_next(&iter, (void**) &file)) {
+        bld_array* times;
+        bld_stats_entry entry;
+
+        if (file->type != BLD_FILE_IMPLEMENTATION && file->type != BLD_FILE_TEST) {continue;}
+
+        times = file_compile_times_get(file);
+        if (times->size == 0) {continue;}
+
+        entry.file = file;
+        entry.latest = *(bld_time*) array_get(times, times->size - 1);
+        entry.previous = 0;
+        if (times->size > 1) {
+            size_t i;
+
+            for (i = 0; i < times->size - 1; i++) {
+                entry.previous += *(bld_time*) array_get(times, i);
+            }
+            entry.previous /= times->size - 1;
+        }
+
+        array_push(&entries, &entry);
+    }
+    qsort(entries.values, entries.size, entries.value_size, command_stats_entry_compare);
+
+    command_stats_builds(&project.base.cache.builds);
+    command_stats_slowest(&entries);
+    command_stats_critical_path(&project.base.cache.builds);
+    command_stats_regressions(&entries, cmd->regression);
+
+    array_free(&entries);
+    project_free(&project);
+    return 0;
+}
+
+int command_stats_entry_compare(const void* a, const void* b) {
+    const bld_stats_entry* e1 = a;
+    const bld_stats_entry* e2 = b;
+
+    if (e1->latest < e2->latest) {
+        return 1;
+    } else if (e1->latest > e2->latest) {
+        return -1;
+    }
+    return strcmp(path_to_string(&e1->file->path), path_to_string(&e2->file->path));
+}
+
+void command_stats_print_time(char* prefix, bld_time time) {
+    printf("%s%5" PRIuMAX ".%01" PRIuMAX " ms", prefix, time / 1000, (time % 1000) / 100);
+}
+
+void command_stats_builds(bld_array* builds) {
+    size_t hits, total;
+    bld_iter iter;
+    bld_build_stats* stats;
+
+    stats = array_get(builds, builds->size - 1);
+    total = stats->compiled + stats->cached;
+
+    printf("\nLast build:\n");
+    printf("  Compiled:  %" PRIuMAX " file(s), %" PRIuMAX " from cache", stats->compiled, stats->cached);
+    if (total > 0) {
+        printf(" (hit ratio %.1f%%)", 100.0 * stats->cached / total);
+    }
+    printf("\n");
+    command_stats_print_time("  Wall time:", stats->wall_time);
+    printf("\n");
+    command_stats_print_time("  CPU time: ", stats->cpu_time);
+    if (stats->wall_time > 0) {
+        printf(" (%.2fx wall time)", (double) stats->cpu_time / stats->wall_time);
+    }
+    printf("\n");
+
+    hits = 0;
+    total = 0;
+    iter = iter_array(builds);
+    while (iter_next(&iter, (void**) &stats)) {
+        hits += stats->cached;
+        total += stats->compiled + stats->cached;
+    }
+
+    if (total > 0) {
+        printf("  Hit ratio over last %lu build(s): %.1f%%\n", (unsigned long) builds->size, 100.0 * hits / total);
+    }
+}
+
+void command_stats_slowest(bld_array* entries) {
+    size_t i;
+    bld_stats_entry* entry;
+
+    if (entries->size == 0) {return;}
+
+    printf("\nSlowest translation units:\n");
+    for (i = 0; i < entries->size && i < BLD_COMMAND_STATS_SLOWEST; i++) {
+        entry = array_get(entries, i);
+        command_stats_print_time("  ", entry->latest);
+        printf("  %s\n", path_to_string(&entry->file->path));
+    }
+}
+
+void command_stats_critical_path(bld_array* builds) {
+    size_t i;
+    bld_build_stats* stats;
+
+    stats = NULL;
+    for (i = builds->size; i > 0; i--) {
+        stats = array_get(builds, i - 1);
+        if (stats->compiled > 0) {break;}
+        stats = NULL;
+    }
+    if (stats == NULL) {return;}
+
+    printf("\nEstimated critical path (latest build that compiled):\n");
+    command_stats_print_time("  ", stats->longest_compile);
+    printf("  longest compile job\n");
+    command_stats_print_time("  ", stats->link_time);
+    printf("  link\n");
+    command_stats_print_time("  ", stats->longest_compile + stats->link_time);
+    printf("  total\n");
+}
+
+void command_stats_regressions(bld_array* entries, int threshold) {
+    int found;
+    bld_iter iter;
+    bld_stats_entry* entry;
+
+    found = 0;
+    iter = iter_array(entries);
+    while (iter_next(&iter, (void**) &entry)) {
+        if (entry->previous == 0) {continue;}
+        if (100 * entry->latest <= (uintmax_t) (100 + threshold) * entry->previous) {continue;}
+
+        if (!found) {
+            printf("\nRegressions, compile time grew more than %d%%:\n", threshold);
+            found = 1;
+        }
+
+        command_stats_print_time("  ", entry->previous);
+        command_stats_print_time(" ->", entry->latest);
+        printf(" (+%.1f%%)  %s\n", 100.0 * (entry->latest - entry->previous) / entry->previous, path_to_string(&entry->file->path));
+    }
+
+    if (!found) {
+        printf("\nNo regressions, no compile time grew more than %d%%\n", threshold);
+    }
+}
+
+int command_stats_convert(bld_command* pre_cmd, bld_data* data, bld_command_stats* cmd, bld_command_invalid* invalid) {
+    int error;
+    bld_string err;
+    bld_command_positional* arg;
+    bld_command_positional_optional* target;
+    bld_command_flag* flag;
+
+    if (!data->has_root) {
+        error = -1;
+        err = string_copy(&bld_command_init_missing_project);
+        goto parse_failed;
+    }
+
+    if (data->targets.size == 0) {
+        error = -1;
+        err = string_copy(&bld_command_init_no_targets);
+        goto parse_failed;
+    }
+
+    arg = array_get(&pre_cmd->positional, 1);
+    if (arg->type != BLD_HANDLE_POSITIONAL_OPTIONAL) {log_fatal(LOG_FATAL_PREFIX "missing first optional");}
+    target = &arg->as.opt;
+
+    if (!utils_get_target(&cmd->target, &err, target, data)) {
+        error = -1;
+        goto parse_failed;
+    }
+
+    cmd->regression = BLD_COMMAND_STATS_REGRESSION;
+    flag = set_get(&pre_cmd->flags, string_hash(string_unpack(&bld_command_string_stats_flag_regression)));
+    if (flag != NULL) {
+        char* end;
+
+        cmd->regression = strtol(string_unpack(&flag->value), &end, 10);
+        if (*end != '\0' || end == string_unpack(&flag->value) || cmd->regression < 0) {
+            error = -1;
+            err = string_new();
+            string_append_string(&err, "regression threshold must be a non-negative integer, got \"");
+            string_append_string(&err, string_unpack(&flag->value));
+            string_append_string(&err, "\"\n");
+            string_free(&cmd->target);
+            goto parse_failed;
+        }
+    }
+
+    return 0;
+    parse_failed:
+    *invalid = command_invalid_new(error, &err);
+    return -1;
+}
+
+bld_handle_annotated command_handle_stats(char* name) {
+    bld_handle_annotated handle;
+
+    handle.type = BLD_COMMAND_STATS;
+    handle.name = bld_command_string_stats;
+    handle.handle = handle_new(name);
+    handle_positional_expect(&handle.handle, string_unpack(&bld_command_string_stats));
+    handle_positional_optional(&handle.handle, "The target to show build statistics of");
+    handle_allow_flags(&handle.handle);
+    handle_flag_value(&handle.handle, ' ', string_unpack(&bld_command_string_stats_flag_regression), "Percentage a compile time has to grow by to be flagged, default 20");
+    handle_set_description(
+        &handle.handle,
+        "Prints statistics of the last builds of a target, the slowest\n"
+        "translation units, CPU time against wall time, the cache hit ratio\n"
+        "and the estimated critical path through the build.\n"
+        "\n"
+        "The compile time of every file is kept for the last builds, files\n"
+        "whose latest compile time grew by more than the threshold compared to\n"
+        "the average of the earlier builds are flagged as regressions."
+    );
+
+    handle.convert = (bld_command_convert*) command_stats_convert;
+    handle.execute = (bld_command_execute*) command_stats;
+    handle.free = (bld_command_free*) command_stats_free;
+
+    return handle;
+}
+
+void command_stats_free(bld_command_stats* cmd) {
+    string_free(&cmd->target);
+}
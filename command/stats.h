@@ -0,0 +1,23 @@
+#ifndef COMMAND_STATS_H
+#define COMMAND_STATS_H
+#include "../bld_core/dstr.h"
+#include "../bld_core/args.h"
+#include "handle.h"
+#include "invalid.h"
+
+#define BLD_COMMAND_STATS_SLOWEST (10)
+#define BLD_COMMAND_STATS_REGRESSION (20)
+
+extern const bld_string bld_command_string_stats;
+
+typedef struct bld_command_stats {
+    bld_string target;
+    int regression;
+} bld_command_stats;
+
+bld_handle_annotated command_handle_stats(char*);
+int command_stats_convert(bld_command*, bld_data*, bld_command_stats*, bld_command_invalid*);
+int command_stats(bld_command_stats*, bld_data*);
+void command_stats_free(bld_command_stats*);
+
+#endif
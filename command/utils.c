@@ -13,7 +13,12 @@
 #include "invalidate.h"
 #include "remove.h"
 #include "status.h"
+#include "stats.h"
+#include "explain.h"
+#include "analyze.h"
+#include "profile.h"
 #include "build.h"
+#include "build_targets.h"
 #include "invalid.h"
 #include "command_test.h"
 
@@ -119,8 +124,13 @@ bld_data data_extract(char* name) {
     data_add_handle(&data, command_handle_remove(name));
     data_add_handle(&data, command_handle_invalidate(name));
     data_add_handle(&data, command_handle_status(name));
+    data_add_handle(&data, command_handle_stats(name));
+    data_add_handle(&data, command_handle_explain(name));
+    data_add_handle(&data, command_handle_analyze(name));
+    data_add_handle(&data, command_handle_profile(name));
     data_add_handle(&data, command_handle_test(name));
     data_add_handle(&data, command_handle_init(name));
+    data_add_handle(&data, command_handle_build_targets(name));
     data_add_handle(&data, command_handle_build(name));
     data_add_handle(&data, command_handle_invalid(name));
 
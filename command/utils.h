@@ -41,7 +41,12 @@ typedef enum bld_command_type {
     BLD_COMMAND_INVALIDATE,
     BLD_COMMAND_LINKER,
     BLD_COMMAND_STATUS,
-    BLD_COMMAND_TEST
+    BLD_COMMAND_TEST,
+    BLD_COMMAND_STATS,
+    BLD_COMMAND_EXPLAIN,
+    BLD_COMMAND_ANALYZE,
+    BLD_COMMAND_PROFILE,
+    BLD_COMMAND_BUILD_TARGETS
 } bld_command_type;
 
 typedef struct bld_handle_annotated {
@@ -27,7 +27,7 @@ void serialize_config(bld_path* path, bld_config* config) {
     FILE* file;
     int depth;
 
-    file = fopen(path_to_string(path), "w");
+    file = json_create(path_to_string(path));
     if (file == NULL) {
         log_fatal("Could not open config file \"%s\"", path_to_string(path));
         return;
@@ -35,24 +35,24 @@ void serialize_config(bld_path* path, bld_config* config) {
 
     depth = 1;
 
-    fprintf(file, "{\n");
+    fputs("{\n", file);
 
     json_serialize_key(file, "log_level", depth);
-    fprintf(file, "\"%s\"", string_unpack(log_level_to_string(config->log_level)));
+    json_serialize_string(file, string_unpack(log_level_to_string(config->log_level)));
 
     if (config->text_editor_configured) {
-        fprintf(file, ",\n");
+        fputs(",\n", file);
         json_serialize_key(file, "text_editor", depth);
-        fprintf(file, "\"%s\"", string_unpack(&config->text_editor));
+        json_serialize_string(file, string_unpack(&config->text_editor));
     }
 
     if (config->active_target_configured) {
-        fprintf(file, ",\n");
+        fputs(",\n", file);
         json_serialize_key(file, "default_target", depth);
-        fprintf(file, "\"%s\"", string_unpack(&config->active_target));
+        json_serialize_string(file, string_unpack(&config->active_target));
     }
 
-    fprintf(file, "\n}");
+    fputs("\n}", file);
     fclose(file);
 }
 
@@ -68,7 +68,7 @@ int parse_config(bld_path* path, bld_config* config) {
         (bld_parse_func) parse_config_default_target,
     };
 
-    file = fopen(path_to_string(path), "r");
+    file = json_open(path_to_string(path));
     if (file == NULL) {
         log_warn("Cannot read config file with path: \"%s\"", path_to_string(path));
         return -1;
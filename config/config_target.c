@@ -1,8 +1,10 @@
+#include <string.h>
 #include "../bld_core/logging.h"
 #include "../bld_core/json.h"
 #include "config_target.h"
 
 void serialize_config_target_file(FILE*, bld_target_build_information*, int);
+void serialize_config_target_profiles(FILE*, bld_array*, int);
 
 int parse_config_target_main(FILE*, bld_config_target*);
 int parse_config_target_linker(FILE*, bld_config_target*);
@@ -11,6 +13,11 @@ int parse_config_target_added_paths(FILE*, bld_config_target*);
 int parse_config_target_ignored_paths(FILE*, bld_config_target*);
 int parse_config_target_paths(FILE*, bld_array*);
 int parse_config_target_path(FILE*, bld_array*);
+int parse_config_target_profiles(FILE*, bld_config_target*);
+int parse_config_target_profile(FILE*, bld_array*);
+int parse_config_profile_name(FILE*, bld_config_profile*);
+int parse_config_profile_compiler_flags(FILE*, bld_config_profile*);
+int parse_config_profile_linker_flags(FILE*, bld_config_profile*);
 
 int parse_target_build_info(FILE*, bld_target_build_information*);
 int parse_target_build_info_file_name(FILE*, bld_target_build_information*);
@@ -30,6 +37,7 @@ bld_config_target config_target_new(bld_path* path) {
     config.linker_set = 0;
     config.compiler_types = set_new(sizeof(bld_compiler_type));
     config.files_set = 0;
+    config.profiles = array_new(sizeof(bld_config_profile));
     return config;
 }
 
@@ -57,6 +65,54 @@ void config_target_free(bld_config_target* config) {
     if (config->files_set) {
         config_target_build_info_free(&config->files);
     }
+
+    {
+        bld_config_profile* profile;
+
+        iter = iter_array(&config->profiles);
+        while (iter_next(&iter, (void**) &profile)) {
+            config_profile_free(profile);
+        }
+        array_free(&config->profiles);
+    }
+}
+
+bld_config_profile config_profile_new(char* name) {
+    bld_config_profile profile;
+
+    profile.name = string_pack(name);
+    profile.name = string_copy(&profile.name);
+    profile.compiler_flags = compiler_flags_new();
+    profile.linker_flags = linker_flags_new();
+    return profile;
+}
+
+void config_profile_free(bld_config_profile* profile) {
+    string_free(&profile->name);
+    compiler_flags_free(&profile->compiler_flags);
+    linker_flags_free(&profile->linker_flags);
+}
+
+bld_config_profile* config_target_get_profile(bld_config_target* config, bld_string* name) {
+    bld_iter iter;
+    bld_config_profile* profile;
+
+    iter = iter_array(&config->profiles);
+    while (iter_next(&iter, (void**) &profile)) {
+        if (string_eq(&profile->name, name)) {
+            return profile;
+        }
+    }
+    return NULL;
+}
+
+int config_profile_name_valid(bld_string* name) {
+    char* str;
+
+    /* The name is a directory under the cache of the target */
+    str = string_unpack(name);
+    if (name->size == 0 || strcmp(str, ".") == 0 || strcmp(str, "..") == 0) {return 0;}
+    return strchr(str, '/') == NULL && strchr(str, '\\') == NULL;
 }
 
 void config_target_build_info_free(bld_target_build_information* info) {
@@ -77,19 +133,19 @@ void serialize_config_target(bld_path* path, bld_config_target* config) {
     FILE* file;
     int depth;
 
-    file = fopen(path_to_string(path), "w");
+    file = json_create(path_to_string(path));
     if (file == NULL) {
         log_fatal("Could not open target config file \"%s\"", path_to_string(path));
         return;
     }
 
     depth = 1;
-    fprintf(file, "{\n");
+    fputs("{\n", file);
 
     json_serialize_key(file, "main", depth);
-    fprintf(file, "\"%s\"", path_to_string(&config->path_main));
+    json_serialize_string(file, path_to_string(&config->path_main));
 
-    fprintf(file, ",\n");
+    fputs(",\n", file);
     json_serialize_key(file, "added_paths", depth);
     {
         bld_iter iter;
@@ -97,23 +153,25 @@ void serialize_config_target(bld_path* path, bld_config_target* config) {
         int first;
 
         first = 1;
-        fprintf(file, "[");
+        fputc('[', file);
         iter = iter_array(&config->added_paths);
         while (iter_next(&iter, (void**) &path)) {
             if (!first) {
-                fprintf(file, ",");
+                fputc(',', file);
             }
             first = 0;
-            fprintf(file, "\n%*c", 2 * (depth + 1), ' ');
-            fprintf(file, "\"%s\"", path_to_string(path));
+            fputc('\n', file);
+            json_serialize_indent(file, 2 * (depth + 1));
+            json_serialize_string(file, path_to_string(path));
         }
         if (config->added_paths.size > 0) {
-            fprintf(file, "\n%*c", 2 * depth, ' ');
+            fputc('\n', file);
+            json_serialize_indent(file, 2 * depth);
         }
-        fprintf(file, "]");
+        fputc(']', file);
     }
 
-    fprintf(file, ",\n");
+    fputs(",\n", file);
     json_serialize_key(file, "ignore_paths", depth);
     {
         bld_iter iter;
@@ -121,46 +179,54 @@ void serialize_config_target(bld_path* path, bld_config_target* config) {
         int first;
 
         first = 1;
-        fprintf(file, "[");
+        fputc('[', file);
         iter = iter_array(&config->ignore_paths);
         while (iter_next(&iter, (void**) &path)) {
             if (!first) {
-                fprintf(file, ",");
+                fputc(',', file);
             }
             first = 0;
-            fprintf(file, "\n%*c", 2 * (depth + 1), ' ');
-            fprintf(file, "\"%s\"", path_to_string(path));
+            fputc('\n', file);
+            json_serialize_indent(file, 2 * (depth + 1));
+            json_serialize_string(file, path_to_string(path));
         }
         if (config->ignore_paths.size > 0) {
-            fprintf(file, "\n%*c", 2 * depth, ' ');
+            fputc('\n', file);
+            json_serialize_indent(file, 2 * depth);
         }
-        fprintf(file, "]");
+        fputc(']', file);
     }
 
     if (config->linker_set) {
-        fprintf(file, ",\n");
+        fputs(",\n", file);
         json_serialize_key(file, "linker", depth);
         serialize_linker(file, &config->linker, depth + 1);
     }
 
     if (config->files_set) {
-        fprintf(file, ",\n");
+        fputs(",\n", file);
         json_serialize_key(file, "files", depth);
         serialize_config_target_file(file, &config->files, depth + 1);
     }
 
-    fprintf(file, "\n}");
+    if (config->profiles.size > 0) {
+        fputs(",\n", file);
+        json_serialize_key(file, "profiles", depth);
+        serialize_config_target_profiles(file, &config->profiles, depth + 1);
+    }
+
+    fputs("\n}", file);
     fclose(file);
 }
 
 void serialize_config_target_file(FILE* file, bld_target_build_information* info, int depth) {
-    fprintf(file, "{\n");
+    fputs("{\n", file);
 
     json_serialize_key(file, "name", depth);
-    fprintf(file, "\"%s\"", string_unpack(&info->name));
+    json_serialize_string(file, string_unpack(&info->name));
 
     if (info->info.compiler_set) {
-        fprintf(file, ",\n");
+        fputs(",\n", file);
         switch (info->info.compiler.type) {
             case (BLD_COMPILER): {
                 json_serialize_key(file, "compiler", depth);
@@ -177,7 +243,7 @@ void serialize_config_target_file(FILE* file, bld_target_build_information* info
 
     if (info->info.linker_set) {
         if (info->info.linker_flags.flags.size > 0) {
-            fprintf(file, ",\n");
+            fputs(",\n", file);
             json_serialize_key(file, "linker_flags", depth);
             serialize_linker_flags(file, &info->info.linker_flags, depth + 1);
         }
@@ -188,44 +254,86 @@ void serialize_config_target_file(FILE* file, bld_target_build_information* info
         bld_iter iter;
         bld_target_build_information* temp;
 
-        fprintf(file, ",\n");
+        fputs(",\n", file);
 
         json_serialize_key(file, "files", depth);
-        fprintf(file, "[\n");
+        fputs("[\n", file);
         first = 1;
         iter = iter_array(&info->files);
         while (iter_next(&iter, (void**) &temp)) {
             if (!first) {
-                fprintf(file, ",\n");
+                fputs(",\n", file);
             } else {
                 first = 0;
             }
-            fprintf(file, "%*c", 2 * (depth + 1), ' ');
+            json_serialize_indent(file, 2 * (depth + 1));
             serialize_config_target_file(file, temp, depth + 2);
         }
 
-        fprintf(file, "\n%*c]", 2 * depth, ' ');
+        fputc('\n', file);
+        json_serialize_indent(file, 2 * depth);
+        fputc(']', file);
     }
 
-    fprintf(file, "\n%*c", 2 * (depth - 1), ' ');
-    fprintf(file, "}");
+    fputc('\n', file);
+    json_serialize_indent(file, 2 * (depth - 1));
+    fputc('}', file);
+}
+
+void serialize_config_target_profiles(FILE* file, bld_array* profiles, int depth) {
+    int first;
+    bld_iter iter;
+    bld_config_profile* profile;
+
+    fputs("[\n", file);
+    first = 1;
+    iter = iter_array(profiles);
+    while (iter_next(&iter, (void**) &profile)) {
+        if (!first) {
+            fputs(",\n", file);
+        } else {
+            first = 0;
+        }
+        json_serialize_indent(file, 2 * depth);
+        fputs("{\n", file);
+
+        json_serialize_key(file, "name", depth + 1);
+        json_serialize_string(file, string_unpack(&profile->name));
+
+        fputs(",\n", file);
+        json_serialize_key(file, "compiler_flags", depth + 1);
+        serialize_compiler_flags(file, &profile->compiler_flags, depth + 2);
+
+        fputs(",\n", file);
+        json_serialize_key(file, "linker_flags", depth + 1);
+        serialize_linker_flags(file, &profile->linker_flags, depth + 2);
+
+        fputc('\n', file);
+        json_serialize_indent(file, 2 * depth);
+        fputc('}', file);
+    }
+
+    fputc('\n', file);
+    json_serialize_indent(file, 2 * (depth - 1));
+    fputc(']', file);
 }
 
 int parse_config_target(bld_path* path, bld_config_target* config) {
     FILE* file;
     int amount_parsed;
-    int size = 5;
-    int parsed[5];
-    char *keys[5] = {"main", "added_paths", "ignore_paths", "linker", "files"};
-    bld_parse_func funcs[5] = {
+    int size = 6;
+    int parsed[6];
+    char *keys[6] = {"main", "added_paths", "ignore_paths", "linker", "files", "profiles"};
+    bld_parse_func funcs[6] = {
         (bld_parse_func) parse_config_target_main,
         (bld_parse_func) parse_config_target_added_paths,
         (bld_parse_func) parse_config_target_ignored_paths,
         (bld_parse_func) parse_config_target_linker,
         (bld_parse_func) parse_config_target_files,
+        (bld_parse_func) parse_config_target_profiles,
     };
 
-    file = fopen(path_to_string(path), "r");
+    file = json_open(path_to_string(path));
     if (file == NULL) {
         log_warn("Cannot read target config file with path: \"%s\"", path_to_string(path));
         return -1;
@@ -236,6 +344,7 @@ int parse_config_target(bld_path* path, bld_config_target* config) {
     config->files_set = 0;
     config->added_paths = array_new(sizeof(bld_path));
     config->ignore_paths = array_new(sizeof(bld_path));
+    config->profiles = array_new(sizeof(bld_config_profile));
     amount_parsed = json_parse_map(file, config, size, parsed, keys, funcs);
     if (!parsed[0] || !parsed[1] || amount_parsed < 0) {
         log_warn("could not parse target config");
@@ -273,6 +382,17 @@ int parse_config_target(bld_path* path, bld_config_target* config) {
         if (parsed[4]) {
             config_target_build_info_free(&config->files);
         }
+
+        {
+            bld_iter iter;
+            bld_config_profile* profile;
+
+            iter = iter_array(&config->profiles);
+            while (iter_next(&iter, (void**) &profile)) {
+                config_profile_free(profile);
+            }
+            array_free(&config->profiles);
+        }
         return -1;
     }
 
@@ -362,6 +482,61 @@ int parse_config_target_path(FILE* file, bld_array* array) {
     return 0;
 }
 
+int parse_config_target_profiles(FILE* file, bld_config_target* config) {
+    int amount_parsed;
+
+    amount_parsed = json_parse_array(file, &config->profiles, (bld_parse_func) parse_config_target_profile);
+    if (amount_parsed < 0) {
+        log_warn("could not parse profiles");
+        return -1;
+    }
+    return 0;
+}
+
+int parse_config_target_profile(FILE* file, bld_array* profiles) {
+    int amount_parsed;
+    int size = 3;
+    int parsed[3];
+    char *keys[3] = {"name", "compiler_flags", "linker_flags"};
+    bld_parse_func funcs[3] = {
+        (bld_parse_func) parse_config_profile_name,
+        (bld_parse_func) parse_config_profile_compiler_flags,
+        (bld_parse_func) parse_config_profile_linker_flags,
+    };
+    bld_config_profile profile;
+
+    amount_parsed = json_parse_map(file, &profile, size, parsed, keys, funcs);
+    if (amount_parsed < size) {
+        log_warn("Profile requires the following fields: [\"%s\", \"%s\", \"%s\"]", keys[0], keys[1], keys[2]);
+
+        if (parsed[0]) {
+            string_free(&profile.name);
+        }
+        if (parsed[1]) {
+            compiler_flags_free(&profile.compiler_flags);
+        }
+        if (parsed[2]) {
+            linker_flags_free(&profile.linker_flags);
+        }
+        return -1;
+    }
+
+    array_push(profiles, &profile);
+    return 0;
+}
+
+int parse_config_profile_name(FILE* file, bld_config_profile* profile) {
+    return string_parse(file, &profile->name);
+}
+
+int parse_config_profile_compiler_flags(FILE* file, bld_config_profile* profile) {
+    return parse_compiler_flags(file, &profile->compiler_flags);
+}
+
+int parse_config_profile_linker_flags(FILE* file, bld_config_profile* profile) {
+    return parse_linker_flags(file, &profile->linker_flags);
+}
+
 int parse_config_target_linker(FILE* file, bld_config_target* config) {
     bld_linker linker;
     int error;
@@ -10,6 +10,12 @@ typedef struct bld_target_build_information {
     bld_array files;
 } bld_target_build_information;
 
+typedef struct bld_config_profile {
+    bld_string name;
+    bld_compiler_flags compiler_flags;
+    bld_linker_flags linker_flags;
+} bld_config_profile;
+
 typedef struct bld_config_target {
     bld_path path_main;
     bld_array added_paths;
@@ -19,6 +25,7 @@ typedef struct bld_config_target {
     bld_set compiler_types;
     int files_set;
     bld_target_build_information files;
+    bld_array profiles;
 } bld_config_target;
 
 bld_config_target config_target_new(bld_path*);
@@ -26,5 +33,9 @@ void config_target_free(bld_config_target*);
 void serialize_config_target(bld_path*, bld_config_target*);
 int parse_config_target(bld_path*, bld_config_target*);
 void config_target_build_info_free(bld_target_build_information*);
+bld_config_profile config_profile_new(char*);
+void config_profile_free(bld_config_profile*);
+bld_config_profile* config_target_get_profile(bld_config_target*, bld_string*);
+int config_profile_name_valid(bld_string*);
 
 #endif